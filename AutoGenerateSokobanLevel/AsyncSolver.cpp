@@ -0,0 +1,47 @@
+#include "pch.h"
+#include "AsyncSolver.h"
+#include <chrono>
+
+AsyncSolver::AsyncSolver(State * state, const SolveLimits & limits, std::function<void(Solver &)> prepare) : solver(state), limits(limits) {
+	cancelflag = false;
+	res = 0;
+	ifgot = false;
+	if (prepare) {
+		prepare(solver);
+	}
+	// ߵȡ־ܱ⹲ȡʱֻԼı־
+	this->limits.handleCancel = &cancelflag;
+	result = std::async(std::launch::async, [this]() {
+		return solver.run(this->limits);
+	});
+}
+
+AsyncSolver::~AsyncSolver() {
+	cancel();
+	if (result.valid()) {
+		result.wait();
+	}
+}
+
+void AsyncSolver::cancel() {
+	cancelflag = true;
+}
+
+bool AsyncSolver::ready() {
+	return ifgot || result.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+bool AsyncSolver::waitFor(double seconds) {
+	if (ifgot) {
+		return true;
+	}
+	return result.wait_for(std::chrono::duration<double>(seconds)) == std::future_status::ready;
+}
+
+int AsyncSolver::get() {
+	if (!ifgot) {
+		res = result.get();
+		ifgot = true;
+	}
+	return res;
+}
\ No newline at end of file
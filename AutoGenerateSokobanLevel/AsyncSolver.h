@@ -0,0 +1,28 @@
+#pragma once
+#include "Solver.h"
+#include <future>
+// ں̨߳ľʱʼ⣬
+// ԲѯǷɡȴЭʽȡʱȡȴ̨߳̽
+class AsyncSolver {
+public:
+	// prepareڿʼ֮ǰڵִ߳Уָλ״ֻ̬run()֮ǰ
+	AsyncSolver(State * state, const SolveLimits & limits, std::function<void(Solver &)> prepare = nullptr);
+	~AsyncSolver();
+	// ȡһ⣬̻߳һμԴʱ0
+	void cancel();
+	// ǷѾ
+	bool ready();
+	// ȴseconds룬ڼ򷵻true
+	bool waitFor(double seconds);
+	// ȴrun()Ľ1н⣬-1޽⣬0ֹ
+	int get();
+	// ԶȡsteplistiterNumȽ
+	Solver solver;
+private:
+	SolveLimits limits;
+	// Լȡ־Ϊlimits.handleCancel⣬Ӱ칲limits.cancel
+	std::atomic<bool> cancelflag;
+	std::future<int> result;
+	int res;
+	bool ifgot;
+};
\ No newline at end of file
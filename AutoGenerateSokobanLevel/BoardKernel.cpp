@@ -0,0 +1,122 @@
+#include "pch.h"
+#include "BoardKernel.h"
+#include <vector>
+
+// WHΪ0ʱʾڳߴ磬¿ߺھƫƶǱڳ
+template<int W, int H>
+static void floodFill(TileType * tiles, int width, int height) {
+	const int w = W > 0 ? W : width;
+	const int h = H > 0 ? H : height;
+	const int offset[4] = { -w, w, -1, 1 };
+	// ÿջһ
+	int fixedstack[W > 0 ? W * H : 1];
+	std::vector<int> dynamicstack;
+	int * stack = fixedstack;
+	if (W == 0) {
+		dynamicstack.resize(w * h);
+		stack = dynamicstack.data();
+	}
+	int top = 0;
+	for (int i = 1; i < h - 1; i++) {
+		for (int j = 1; j < w - 1; j++) {
+			if (tiles[i * w + j] == Character || tiles[i * w + j] == CharacterinAid) {
+				stack[top++] = i * w + j;
+			}
+		}
+	}
+	while (top > 0) {
+		int loc = stack[--top];
+		for (int d = 0; d < 4; d++) {
+			int next = loc + offset[d];
+			if (tiles[next] == Floor) {
+				tiles[next] = Character;
+			}
+			else if (tiles[next] == Aid) {
+				tiles[next] = CharacterinAid;
+			}
+			else {
+				continue;
+			}
+			// ԭɨһ£ֻڲӼչ
+			int ni = next / w;
+			int nj = next % w;
+			if (ni > 0 && ni < h - 1 && nj > 0 && nj < w - 1) {
+				stack[top++] = next;
+			}
+		}
+	}
+}
+
+template<int W, int H>
+static void clearCharacter(TileType * tiles, int width, int height) {
+	const int size = W > 0 ? W * H : width * height;
+	for (int k = 0; k < size; k++) {
+		TileType t = tiles[k];
+		tiles[k] = t == Character ? Floor : t == CharacterinAid ? Aid : t;
+	}
+}
+
+template<int W, int H>
+static bool isEqual(const TileType * a, const TileType * b, int width, int height) {
+	const int size = W > 0 ? W * H : width * height;
+	// ǰ˳̶ߴʱαȽϿԱ
+	bool res = true;
+	for (int k = 0; k < size; k++) {
+		res &= a[k] == b[k];
+	}
+	return res;
+}
+
+template<int W, int H>
+static unsigned int boxCode(const TileType * tiles, int width, int height) {
+	const int size = W > 0 ? W * H : width * height;
+	unsigned int code = 2166136261u;
+	for (int k = 0; k < size; k++) {
+		if (tiles[k] == Box || tiles[k] == BoxinAid) {
+			code = (code ^ (unsigned int)k) * 16777619u;
+		}
+	}
+	code ^= code >> 15;
+	code *= 0x2c1b3c6du;
+	code ^= code >> 12;
+	return code;
+}
+
+template<int W, int H>
+static unsigned long long stateHash(const TileType * tiles, int width, int height) {
+	const int size = W > 0 ? W * H : width * height;
+	unsigned long long code = 14695981039346656037ull;
+	for (int k = 0; k < size; k++) {
+		code = (code ^ (unsigned long long)tiles[k]) * 1099511628211ull;
+	}
+	code ^= code >> 33;
+	code *= 0xff51afd7ed558ccdull;
+	code ^= code >> 33;
+	return code;
+}
+
+template<int W, int H>
+static const BoardOps * boardOps() {
+	static const BoardOps ops = { &floodFill<W, H>, &clearCharacter<W, H>, &isEqual<W, H>, &boxCode<W, H>, &stateHash<W, H> };
+	return &ops;
+}
+
+const BoardOps * selectBoardOps(int width, int height) {
+	if (width == height) {
+		switch (width) {
+		case 6: return boardOps<6, 6>();
+		case 7: return boardOps<7, 7>();
+		case 8: return boardOps<8, 8>();
+		case 9: return boardOps<9, 9>();
+		case 10: return boardOps<10, 10>();
+		case 11: return boardOps<11, 11>();
+		case 12: return boardOps<12, 12>();
+		case 13: return boardOps<13, 13>();
+		case 14: return boardOps<14, 14>();
+		case 15: return boardOps<15, 15>();
+		case 16: return boardOps<16, 16>();
+		default: break;
+		}
+	}
+	return boardOps<0, 0>();
+}
\ No newline at end of file
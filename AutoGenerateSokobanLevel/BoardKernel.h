@@ -0,0 +1,18 @@
+#pragma once
+#include "TileType.h"
+// ڲѭĺóߴ磨6x616x16ʹñڹ̶ߵģʵ֣
+// ھƫƺ鳤ȶǳչߴʹڿߵͨʵ֡
+struct BoardOps {
+	// ÷㷨нɫܹﵽĵص
+	void (*floodFill)(TileType * tiles, int width, int height);
+	// CharacterԭΪFloorCharacterinAidԭΪAid
+	void (*clearCharacter)(TileType * tiles, int width, int height);
+	// жǷȫͬ
+	bool (*isEqual)(const TileType * a, const TileType * b, int width, int height);
+	// λüĹϣ̴ֵС
+	unsigned int (*boxCode)(const TileType * tiles, int width, int height);
+	// ̣ɴ򣩵64λϣֵλ״̬ģʽ
+	unsigned long long (*stateHash)(const TileType * tiles, int width, int height);
+};
+// ̳ߴѡ
+const BoardOps * selectBoardOps(int width, int height);
\ No newline at end of file
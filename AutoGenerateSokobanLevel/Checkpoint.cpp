@@ -0,0 +1,239 @@
+#include "pch.h"
+#include "Checkpoint.h"
+#include "Trace.h"
+#include <cstdio>
+
+static const char FILE_MAGIC[4] = { 'S', 'K', 'C', 'P' };
+static const int FILE_VERSION = 1;
+static const char RECORD_NODE = 'N';
+static const char RECORD_PROGRESS = 'E';
+
+// ȥӣֻǽڡĿͿյ
+static TileType baseTile(TileType t) {
+	if (t == Character || t == Box) {
+		return Floor;
+	}
+	if (t == CharacterinAid || t == BoxinAid) {
+		return Aid;
+	}
+	return t;
+}
+
+// ȥ
+static TileType plainTile(TileType t) {
+	if (t == Character) {
+		return Floor;
+	}
+	if (t == CharacterinAid) {
+		return Aid;
+	}
+	return t;
+}
+
+Checkpoint::Checkpoint(State * basestate) {
+	this->basestate = basestate->clone();
+	width = basestate->width;
+	height = basestate->height;
+	basetiles = new TileType[width * height];
+	for (int k = 0; k < width * height; k++) {
+		basetiles[k] = baseTile(basestate->tiles[k]);
+	}
+	writtenNum = 0;
+}
+
+Checkpoint::~Checkpoint() {
+	if (out.is_open()) {
+		out.close();
+	}
+	delete[] basetiles;
+	delete basestate;
+}
+
+void Checkpoint::writeHeader() {
+	int version = FILE_VERSION;
+	out.write(FILE_MAGIC, 4);
+	out.write((char *)&version, sizeof(version));
+	out.write((char *)&width, sizeof(width));
+	out.write((char *)&height, sizeof(height));
+	for (int k = 0; k < width * height; k++) {
+		char t = (char)basetiles[k];
+		out.write(&t, 1);
+	}
+}
+
+void Checkpoint::writeNode(StateNode * sn) {
+	State * state = sn->currentstate;
+	int record[5] = { sn->parentstate == nullptr ? -1 : sn->parentstate->id, sn->depth, -1, state->cx, state->cy };
+	std::vector<int> diffs;
+	for (int k = 0; k < width * height; k++) {
+		TileType t = state->tiles[k];
+		// ɴֻ¼һӣԭʱ·
+		if (record[2] < 0 && (t == Character || t == CharacterinAid)) {
+			record[2] = k;
+		}
+		if (plainTile(t) != basetiles[k]) {
+			diffs.push_back(k);
+			diffs.push_back(plainTile(t));
+		}
+	}
+	int diffnum = (int)diffs.size() / 2;
+	out.write(&RECORD_NODE, 1);
+	out.write((char *)record, sizeof(record));
+	out.write((char *)&diffnum, sizeof(diffnum));
+	for (int d = 0; d < diffnum; d++) {
+		unsigned short loc = (unsigned short)diffs[2 * d];
+		char t = (char)diffs[2 * d + 1];
+		out.write((char *)&loc, sizeof(loc));
+		out.write(&t, 1);
+	}
+}
+
+void Checkpoint::writeProgress(int nodenum, int expanded, int iterNum) {
+	int record[3] = { nodenum, expanded, iterNum };
+	out.write(&RECORD_PROGRESS, 1);
+	out.write((char *)record, sizeof(record));
+	out.flush();
+}
+
+bool Checkpoint::create(const char * path, std::vector<StateNode*> & nodes, int expanded, int iterNum) {
+	TRACE_SCOPE("Checkpoint::create");
+	if (out.is_open()) {
+		out.close();
+	}
+	filepath = path;
+	std::string temppath = filepath + ".tmp";
+	out.open(temppath.c_str(), std::ios::binary | std::ios::trunc);
+	if (!out) {
+		return false;
+	}
+	writeHeader();
+	for (int n = 0; n < (int)nodes.size(); n++) {
+		writeNode(nodes[n]);
+	}
+	writeProgress((int)nodes.size(), expanded, iterNum);
+	out.close();
+	std::remove(filepath.c_str());
+	if (std::rename(temppath.c_str(), filepath.c_str()) != 0) {
+		return false;
+	}
+	writtenNum = (int)nodes.size();
+	out.open(filepath.c_str(), std::ios::binary | std::ios::app);
+	return (bool)out;
+}
+
+bool Checkpoint::append(std::vector<StateNode*> & nodes, int expanded, int iterNum) {
+	TRACE_SCOPE("Checkpoint::append");
+	if (!out.is_open()) {
+		return false;
+	}
+	appendNodes(nodes);
+	writeProgress(writtenNum, expanded, iterNum);
+	return (bool)out;
+}
+
+void Checkpoint::appendNodes(std::vector<StateNode*> & nodes) {
+	if (!out.is_open()) {
+		return;
+	}
+	for (int n = writtenNum; n < (int)nodes.size(); n++) {
+		writeNode(nodes[n]);
+	}
+	writtenNum = (int)nodes.size();
+}
+
+bool Checkpoint::read(const char * path, std::vector<CheckpointNode> & nodes, int & expanded, int & iterNum) {
+	std::ifstream in(path, std::ios::binary);
+	if (!in) {
+		return false;
+	}
+	char magic[4];
+	int header[3];
+	in.read(magic, 4);
+	in.read((char *)header, sizeof(header));
+	if (!in || magic[0] != FILE_MAGIC[0] || magic[1] != FILE_MAGIC[1] || magic[2] != FILE_MAGIC[2] || magic[3] != FILE_MAGIC[3]) {
+		return false;
+	}
+	if (header[0] != FILE_VERSION || header[1] != width || header[2] != height) {
+		return false;
+	}
+	for (int k = 0; k < width * height; k++) {
+		char t;
+		in.read(&t, 1);
+		if (!in || (TileType)t != basetiles[k]) {
+			return false;
+		}
+	}
+	// ȡļĩβļ¼ֱӶ
+	std::vector<CheckpointNode> records;
+	int validnum = -1;
+	while (true) {
+		char tag;
+		in.read(&tag, 1);
+		if (!in) {
+			break;
+		}
+		if (tag == RECORD_NODE) {
+			CheckpointNode node;
+			int record[5];
+			int diffnum = 0;
+			in.read((char *)record, sizeof(record));
+			in.read((char *)&diffnum, sizeof(diffnum));
+			if (!in || diffnum < 0 || diffnum > width * height) {
+				break;
+			}
+			node.parent = record[0];
+			node.depth = record[1];
+			node.player = record[2];
+			node.cx = record[3];
+			node.cy = record[4];
+			for (int d = 0; d < diffnum; d++) {
+				unsigned short loc;
+				char t;
+				in.read((char *)&loc, sizeof(loc));
+				in.read(&t, 1);
+				node.diffs.push_back(loc);
+				node.diffs.push_back(t);
+			}
+			if (!in) {
+				break;
+			}
+			records.push_back(node);
+		}
+		else if (tag == RECORD_PROGRESS) {
+			int record[3];
+			in.read((char *)record, sizeof(record));
+			if (!in || record[0] > (int)records.size()) {
+				break;
+			}
+			validnum = record[0];
+			expanded = record[1];
+			iterNum = record[2];
+		}
+		else {
+			break;
+		}
+	}
+	if (validnum <= 0) {
+		return false;
+	}
+	records.resize(validnum);
+	nodes.swap(records);
+	return true;
+}
+
+State * Checkpoint::buildState(CheckpointNode & node) {
+	State * state = basestate->clone();
+	for (int k = 0; k < width * height; k++) {
+		state->tiles[k] = basetiles[k];
+	}
+	for (int d = 0; d + 1 < (int)node.diffs.size(); d += 2) {
+		state->tiles[node.diffs[d]] = (TileType)node.diffs[d + 1];
+	}
+	if (node.player >= 0) {
+		state->tiles[node.player] = state->tiles[node.player] == Aid ? CharacterinAid : Character;
+	}
+	state->charFloodFill();
+	state->cx = node.cx;
+	state->cy = node.cy;
+	return state;
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+#pragma once
+#include "State.h"
+#include "StateNode.h"
+#include <fstream>
+#include <string>
+#include <vector>
+// ļеһڵ㣺ֻ̲ͬĸӺλ
+struct CheckpointNode {
+	int parent;
+	int depth;
+	int player;
+	int cx;
+	int cy;
+	// ӱݣ
+	std::vector<int> diffs;
+};
+// ̵ļļļļͷڵ¼ͽȼ¼ɣ
+// дʱֻ׷ϴĽڵ㣬ȡʱһĽȼ¼Ϊ׼
+class Checkpoint {
+public:
+	// basestateĳʼ״ֻ̬ǽںĿĻ̣ڲḴһ
+	Checkpoint(State * basestate);
+	~Checkpoint();
+	// ½ļдnodesеȫڵ㣻дʱļٸдһƻļ
+	bool create(const char * path, std::vector<StateNode*> & nodes, int expanded, int iterNum);
+	// ׷ϴд֮Ľڵһȼ¼
+	bool append(std::vector<StateNode*> & nodes, int expanded, int iterNum);
+	// ֻ׷Ľڵ㣬дȼ¼Ҳˢļȡʱûнȼ¼ǵĽڵᱻ
+	void appendNodes(std::vector<StateNode*> & nodes);
+	// ȡļļͷ̲ʱfalse
+	bool read(const char * path, std::vector<CheckpointNode> & nodes, int & expanded, int & iterNum);
+	// ɽڵ¼ԭ״̬
+	State * buildState(CheckpointNode & node);
+	int width;
+	int height;
+private:
+	TileType * basetiles;
+	State * basestate;
+	std::string filepath;
+	std::ofstream out;
+	// дļĽڵ
+	int writtenNum;
+	void writeHeader();
+	void writeNode(StateNode * sn);
+	void writeProgress(int nodenum, int expanded, int iterNum);
+};
\ No newline at end of file
@@ -1,13 +1,27 @@
 #include"pch.h"
 #include"GenerateLevel.h"
+#include"Trace.h"
 #include<stdlib.h>
 #include<time.h>
 #include"map.h"
+#include"Prefilter.h"
 GenerateLevel::GenerateLevel(int w, int h) {
+	init(w, h, (unsigned long long)time(NULL));
+}
+GenerateLevel::GenerateLevel(int w, int h, unsigned long long seed) {
+	init(w, h, seed);
+}
+GenerateLevel::~GenerateLevel() {
+	delete[] tiles;
+	delete[] savedtiles;
+}
+void GenerateLevel::init(int w, int h, unsigned long long seed) {
 	tiles = new TileType[w * h];
 	savedtiles = new TileType[w * h];
 	width = w;
 	height = h;
+	this->seed = seed;
+	rngstate = seed;
 	// ǽΧͼһȦ
 	for (int i = 0; i < height; i++) {
 		for (int j = 0; j < width; j++) {
@@ -24,12 +38,20 @@ GenerateLevel::GenerateLevel(int w, int h) {
 	// 
 	save();
 }
+unsigned int GenerateLevel::nextRandom() {
+	rngstate += 0x9E3779B97F4A7C15ull;
+	unsigned long long z = rngstate;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+	z = z ^ (z >> 31);
+	return (unsigned int)(z >> 32);
+}
 bool GenerateLevel::generateChar() {
+	TRACE_SCOPE("GenerateLevel::generateChar");
 	int gtime = 1000;
-	srand((unsigned)time(NULL) * 10);
 	while (gtime--) {
-		int randi = rand() % height;
-		int randj = rand() % width;
+		int randi = nextRandom() % height;
+		int randj = nextRandom() % width;
 		if (tiles[randi * width + randj] == Floor) {
 			tiles[randi * width + randj] = Character;
 			return true;
@@ -38,11 +60,11 @@ bool GenerateLevel::generateChar() {
 	return false;
 }
 bool GenerateLevel::generateBox() {
+	TRACE_SCOPE("GenerateLevel::generateBox");
 	int gtime = 1000;
-	srand((unsigned)time(NULL) * 10);
 	while (gtime--) {
-		int randi = rand() % height;
-		int randj = rand() % width;
+		int randi = nextRandom() % height;
+		int randj = nextRandom() % width;
 		if (tiles[randi * width + randj] == Floor) {
 			tiles[randi * width + randj] = Box;
 			return true;
@@ -51,11 +73,11 @@ bool GenerateLevel::generateBox() {
 	return false;
 }
 bool GenerateLevel::generateWall() {
+	TRACE_SCOPE("GenerateLevel::generateWall");
 	int gtime = 1000;
-	srand((unsigned)time(NULL) * 10);
 	while (gtime--) {
-		int randi = rand() % height;
-		int randj = rand() % width;
+		int randi = nextRandom() % height;
+		int randj = nextRandom() % width;
 		if (tiles[randi * width + randj] == Floor) {
 			tiles[randi * width + randj] = Wall;
 			return true;
@@ -64,11 +86,11 @@ bool GenerateLevel::generateWall() {
 	return false;
 }
 bool GenerateLevel::generateAid() {
+	TRACE_SCOPE("GenerateLevel::generateAid");
 	int gtime = 1000;
-	srand((unsigned)time(NULL) * 10);
 	while (gtime--) {
-		int randi = rand() % height;
-		int randj = rand() % width;
+		int randi = nextRandom() % height;
+		int randj = nextRandom() % width;
 		if (tiles[randi * width + randj] == Floor) {
 			tiles[randi * width + randj] = Aid;
 			return true;
@@ -78,6 +100,7 @@ bool GenerateLevel::generateAid() {
 }
 
 void GenerateLevel::save() {
+	TRACE_SCOPE("GenerateLevel::save");
 	for (int i = 0; i < height; i++) {
 		for (int j = 0; j < width; j++) {
 			savedtiles[i * width + j] = tiles[i * width + j];
@@ -85,9 +108,74 @@ void GenerateLevel::save() {
 	}
 }
 void GenerateLevel::load() {
+	TRACE_SCOPE("GenerateLevel::load");
 	for (int i = 0; i < height; i++) {
 		for (int j = 0; j < width; j++) {
 			tiles[i * width + j] = savedtiles[i * width + j];
 		}
 	}
+}
+void GenerateLevel::mutate() {
+	if (nextRandom() % 2) {
+		generateBox();
+		generateAid();
+	}
+	else {
+		generateWall();
+	}
+}
+int GenerateLevel::generate(int trytime, const SolveLimits & limits, std::function<void(State *, Solver &)> onSolved) {
+	int steps = -1;
+	int remaintime = trytime;
+	accepted.clear();
+	for (int candidatenum = 0; remaintime--; candidatenum++) {
+		TRACE_SCOPE("GenerateLevel::candidate");
+		mutate();
+		// ڸ⣬Stateʱͷ
+		TileType * candidate = new TileType[width * height];
+		for (int k = 0; k < width * height; k++) {
+			candidate[k] = tiles[k];
+		}
+		State * state = new State(width, height);
+		state->setLevel(candidate);
+		int res = -1;
+		// ñҪų޽ĹؿʡȥSolver
+		Prefilter prefilter(state);
+		if (prefilter.run()) {
+			Solver solver(state);
+			res = solver.run(limits);
+			if (res == 1) {
+				steps = (int)solver.steplist.size() - 1;
+				remaintime = trytime;
+				accepted.push_back(candidatenum);
+				save();
+				if (onSolved) {
+					onSolved(state, solver);
+				}
+			}
+		}
+		// ޽򳬳ƵĹؿ
+		if (res != 1) {
+			load();
+		}
+		delete state;
+	}
+	return steps;
+}
+void GenerateLevel::replay(const std::vector<int> & accepted) {
+	TRACE_SCOPE("GenerateLevel::replay");
+	int candidatenum = 0;
+	for (size_t k = 0; k < accepted.size(); k++) {
+		for (; candidatenum <= accepted[k]; candidatenum++) {
+			mutate();
+			if (candidatenum == accepted[k]) {
+				save();
+			}
+			else {
+				load();
+			}
+		}
+	}
+	// һν֮ĺѡؿͣ󱣴״̬
+	this->accepted = accepted;
 }
\ No newline at end of file
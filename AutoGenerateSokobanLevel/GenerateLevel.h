@@ -1,5 +1,8 @@
 #pragma once
 #include "TileType.h"
+#include "Solver.h"
+#include <functional>
+#include <vector>
 
 class GenerateLevel {
 public:
@@ -7,7 +10,15 @@ public:
 	int height;
 	TileType * tiles;
 	TileType * savedtiles;
+	// ӣͬĳߴ硢ӺɲǵõͬĹؿ
+	unsigned long long seed;
+	// ָʱõǰʱΪӣӱseedУ֮Կɸ
 	GenerateLevel(int w, int h);
+	GenerateLevel(int w, int h, unsigned long long seed);
+	~GenerateLevel();
+	// ӵ飬
+	GenerateLevel(const GenerateLevel &) = delete;
+	GenerateLevel & operator=(const GenerateLevel &) = delete;
 	
 	bool generateChar();
 	bool generateBox();
@@ -16,4 +27,20 @@ public:
 
 	void save();
 	void load();
+	// ̰ĵɣÿһӺĿһǽȻнͱ
+	// trytimeʧֹܺͣչؿ̽Ӵûеõнؿʱ-1
+	// Ҫ֤ɸ֣limitsֻ״̬ʱ䣻onSolvedÿεõнؿʱá
+	int generate(int trytime, const SolveLimits & limits, std::function<void(State *, Solver &)> onSolved = nullptr);
+	// generate()бܵĺѡؿţ0ʼֻڹѡؿʱʹã
+	// ͬһ°ЩطžܵõͬĹؿ
+	std::vector<int> accepted;
+	// ⣬acceptedطɹ̣õgenerate()ͬչؿ
+	void replay(const std::vector<int> & accepted);
+	// ƽ̨޹صȷsplitmix64
+	unsigned int nextRandom();
+private:
+	unsigned long long rngstate;
+	void init(int w, int h, unsigned long long seed);
+	// һӺĿһǽõһѡؿ
+	void mutate();
 };
\ No newline at end of file
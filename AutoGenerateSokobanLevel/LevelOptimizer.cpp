@@ -0,0 +1,238 @@
+#include "pch.h"
+#include "LevelOptimizer.h"
+#include "Trace.h"
+#include "Prefilter.h"
+#include <thread>
+#include <cmath>
+
+// 
+static const int M_ADDWALL = 0;
+static const int M_REMOVEWALL = 1;
+static const int M_MOVEWALL = 2;
+static const int M_ADDPAIR = 3;
+static const int M_REMOVEPAIR = 4;
+static const int M_MOVEBOX = 5;
+static const int M_MOVEAID = 6;
+static const int M_MOVECHAR = 7;
+static const int M_NUM = 8;
+// ޽ؿ
+static const double NO_SCORE = -1e9;
+
+LevelOptimizer::LevelOptimizer(const OptimizerOptions & options) {
+	this->options = options;
+	bestscore = NO_SCORE;
+	beststeps = 0;
+	swapNum = 0;
+	swapTryNum = 0;
+	int w = options.width;
+	int h = options.height;
+	for (int r = 0; r < options.replicas; r++) {
+		Replica replica;
+		replica.rng.seed(options.seed + 7919u * r);
+		replica.temperature = options.minTemperature;
+		if (options.replicas > 1) {
+			replica.temperature = options.minTemperature * pow(options.maxTemperature / options.minTemperature, (double)r / (options.replicas - 1));
+		}
+		// ʼؿһȦǽڡһɫһ/Ŀ
+		replica.tiles.assign(w * h, Floor);
+		for (int i = 0; i < h; i++) {
+			for (int j = 0; j < w; j++) {
+				if (i == 0 || i == h - 1 || j == 0 || j == w - 1) {
+					replica.tiles[i * w + j] = Wall;
+				}
+			}
+		}
+		int cell = randomCell(replica.tiles, replica.rng, Floor);
+		replica.tiles[cell] = Character;
+		cell = randomCell(replica.tiles, replica.rng, Floor);
+		replica.tiles[cell] = Box;
+		cell = randomCell(replica.tiles, replica.rng, Floor);
+		replica.tiles[cell] = Aid;
+		replica.score = NO_SCORE;
+		replica.steps = 0;
+		replica.acceptNum = 0;
+		replica.tryNum = 0;
+		replicas.push_back(replica);
+	}
+}
+
+LevelOptimizer::~LevelOptimizer() {
+}
+
+int LevelOptimizer::randomCell(std::vector<TileType> & tiles, std::mt19937 & rng, TileType type) {
+	int w = options.width;
+	int h = options.height;
+	std::vector<int> cells;
+	for (int i = 1; i < h - 1; i++) {
+		for (int j = 1; j < w - 1; j++) {
+			if (tiles[i * w + j] == type) {
+				cells.push_back(i * w + j);
+			}
+		}
+	}
+	if (cells.size() == 0) {
+		return -1;
+	}
+	return cells[rng() % cells.size()];
+}
+
+bool LevelOptimizer::mutate(std::vector<TileType> & tiles, std::mt19937 & rng) {
+	TRACE_SCOPE("LevelOptimizer::mutate");
+	int kind = rng() % M_NUM;
+	int from = -1;
+	int to = -1;
+	switch (kind) {
+	case M_ADDWALL:
+		to = randomCell(tiles, rng, Floor);
+		if (to < 0) {
+			return false;
+		}
+		tiles[to] = Wall;
+		return true;
+	case M_REMOVEWALL:
+		from = randomCell(tiles, rng, Wall);
+		if (from < 0) {
+			return false;
+		}
+		tiles[from] = Floor;
+		return true;
+	case M_MOVEWALL:
+		from = randomCell(tiles, rng, Wall);
+		to = randomCell(tiles, rng, Floor);
+		if (from < 0 || to < 0) {
+			return false;
+		}
+		tiles[from] = Floor;
+		tiles[to] = Wall;
+		return true;
+	case M_ADDPAIR:
+		to = randomCell(tiles, rng, Floor);
+		if (to < 0) {
+			return false;
+		}
+		tiles[to] = Box;
+		from = randomCell(tiles, rng, Floor);
+		if (from < 0) {
+			tiles[to] = Floor;
+			return false;
+		}
+		tiles[from] = Aid;
+		return true;
+	case M_REMOVEPAIR:
+		from = randomCell(tiles, rng, Box);
+		to = randomCell(tiles, rng, Aid);
+		if (from < 0 || to < 0) {
+			return false;
+		}
+		tiles[from] = Floor;
+		tiles[to] = Floor;
+		return true;
+	case M_MOVEBOX:
+	case M_MOVEAID:
+	case M_MOVECHAR: {
+		TileType type = kind == M_MOVEBOX ? Box : kind == M_MOVEAID ? Aid : Character;
+		from = randomCell(tiles, rng, type);
+		to = randomCell(tiles, rng, Floor);
+		if (from < 0 || to < 0) {
+			return false;
+		}
+		tiles[from] = Floor;
+		tiles[to] = type;
+		return true;
+	}
+	default:
+		return false;
+	}
+}
+
+bool LevelOptimizer::evaluate(std::vector<TileType> & tiles, double & score, int & steps) {
+	TRACE_SCOPE("LevelOptimizer::evaluate");
+	int w = options.width;
+	int h = options.height;
+	TileType * leveltiles = new TileType[w * h];
+	for (int k = 0; k < w * h; k++) {
+		leveltiles[k] = tiles[k];
+	}
+	State * state = new State(w, h);
+	state->setLevel(leveltiles);
+	bool res = false;
+	Prefilter prefilter(state);
+	if (prefilter.run()) {
+		Solver solver(state);
+		if (solver.run(options.limits) == 1) {
+			// ֣̽ӴĶΪѶȵĲ
+			steps = (int)solver.steplist.size() - 1;
+			score = steps + log2(1.0 + solver.iterNum);
+			res = true;
+		}
+	}
+	delete state;
+	return res;
+}
+
+void LevelOptimizer::runChain(Replica & replica) {
+	TRACE_THREAD_NAME("optimizer chain");
+	if (replica.score == NO_SCORE) {
+		evaluate(replica.tiles, replica.score, replica.steps);
+	}
+	std::uniform_real_distribution<double> uniform(0.0, 1.0);
+	for (int s = 0; s < options.stepsPerRound; s++) {
+		std::vector<TileType> candidate = replica.tiles;
+		if (!mutate(candidate, replica.rng)) {
+			continue;
+		}
+		replica.tryNum++;
+		double score;
+		int steps;
+		if (!evaluate(candidate, score, steps)) {
+			continue;
+		}
+		// Metropolis׼򣺸õĹؿǽܣİexp(ֵ/¶)ĸʽ
+		if (score >= replica.score || uniform(replica.rng) < exp((score - replica.score) / replica.temperature)) {
+			replica.tiles.swap(candidate);
+			replica.score = score;
+			replica.steps = steps;
+			replica.acceptNum++;
+			std::lock_guard<std::mutex> guard(bestlock);
+			if (score > bestscore) {
+				bestscore = score;
+				beststeps = steps;
+				besttiles = replica.tiles;
+			}
+		}
+	}
+}
+
+void LevelOptimizer::swapReplicas(int round) {
+	std::uniform_real_distribution<double> uniform(0.0, 1.0);
+	// żֽ波(0,1)(2,3)...(1,2)(3,4)...
+	for (int r = round % 2; r + 1 < (int)replicas.size(); r += 2) {
+		Replica & cold = replicas[r];
+		Replica & hot = replicas[r + 1];
+		swapTryNum++;
+		double delta = (hot.score - cold.score) * (1.0 / cold.temperature - 1.0 / hot.temperature);
+		if (delta >= 0 || uniform(cold.rng) < exp(delta)) {
+			cold.tiles.swap(hot.tiles);
+			std::swap(cold.score, hot.score);
+			std::swap(cold.steps, hot.steps);
+			swapNum++;
+		}
+	}
+}
+
+void LevelOptimizer::runRound(int round) {
+	std::vector<std::thread> threads;
+	for (int r = 0; r < (int)replicas.size(); r++) {
+		threads.push_back(std::thread(&LevelOptimizer::runChain, this, std::ref(replicas[r])));
+	}
+	for (int r = 0; r < (int)threads.size(); r++) {
+		threads[r].join();
+	}
+	swapReplicas(round);
+}
+
+void LevelOptimizer::run() {
+	for (int round = 0; round < options.rounds; round++) {
+		runRound(round);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+#pragma once
+#include "TileType.h"
+#include "Solver.h"
+#include <random>
+#include <vector>
+#include <mutex>
+// лػŻĲ
+struct OptimizerOptions {
+	int width = 7;
+	int height = 7;
+	// ÿһ߳
+	int replicas = 4;
+	// ¶ȴ͵߰μ
+	double minTemperature = 0.3;
+	double maxTemperature = 6.0;
+	// ÿÿıÿֽ󽻻¶ȵ
+	int stepsPerRound = 20;
+	int rounds = 50;
+	unsigned int seed = 0;
+	// ѡؿ
+	SolveLimits limits;
+};
+// һ
+struct Replica {
+	std::vector<TileType> tiles;
+	double score;
+	int steps;
+	double temperature;
+	std::mt19937 rng;
+	int acceptNum;
+	int tryNum;
+};
+// лػ𣨸ؿŻڲͬ¶¶Թؿ
+// ɾƶǽڡӺĿ㣩ĲѶȴֲMetropolis׼ܣ
+// ÿֽ¶ȵ׼򽻻ؿ
+class LevelOptimizer {
+public:
+	LevelOptimizer(const OptimizerOptions & options);
+	~LevelOptimizer();
+	// ȫִΣɺbesttilesбõĹؿ
+	void run();
+	// бһ֣Ȼ󽻻¶ȵ
+	void runRound(int round);
+	// ؿ֣޽򳬳ʱfalse
+	bool evaluate(std::vector<TileType> & tiles, double & score, int & steps);
+	OptimizerOptions options;
+	std::vector<Replica> replicas;
+	std::vector<TileType> besttiles;
+	double bestscore;
+	int beststeps;
+	int swapNum;
+	int swapTryNum;
+private:
+	// һִstepsPerRoundα
+	void runChain(Replica & replica);
+	// 죬falseʾûҵԱλ
+	bool mutate(std::vector<TileType> & tiles, std::mt19937 & rng);
+	// ȡһڲӣҲʱ-1
+	int randomCell(std::vector<TileType> & tiles, std::mt19937 & rng, TileType type);
+	void swapReplicas(int round);
+	std::mutex bestlock;
+};
\ No newline at end of file
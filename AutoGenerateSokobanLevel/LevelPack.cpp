@@ -0,0 +1,176 @@
+#include "pch.h"
+#include "LevelPack.h"
+#include "GenerateLevel.h"
+#include "Trace.h"
+#include <fstream>
+
+static const char FILE_MAGIC[4] = { 'S', 'K', 'S', 'P' };
+static const int FILE_VERSION = 2;
+// ¼ûнʱӰ汾1һûɹдڽܴλõֵ
+static const unsigned short NO_DECISIONS = 0xFFFF;
+
+LevelPack::LevelPack() {
+	tryTimes = 100;
+	maxNodes = 1000000;
+}
+
+LevelPack::~LevelPack() {
+}
+
+int LevelPack::generate(LevelSeed & level, std::vector<TileType> & tiles) {
+	TRACE_SCOPE("LevelPack::generate");
+	GenerateLevel gl(level.width, level.height, level.seed);
+	// ֻ״̬޹
+	SolveLimits limits;
+	limits.maxNodes = level.maxNodes;
+	level.steps = gl.generate(level.tryTimes, limits);
+	level.accepted = gl.accepted;
+	level.hasDecisions = true;
+	tiles.assign(gl.tiles, gl.tiles + level.width * level.height);
+	return level.steps;
+}
+
+void LevelPack::replay(const LevelSeed & level, std::vector<TileType> & tiles) {
+	TRACE_SCOPE("LevelPack::replay");
+	GenerateLevel gl(level.width, level.height, level.seed);
+	gl.replay(level.accepted);
+	tiles.assign(gl.tiles, gl.tiles + level.width * level.height);
+}
+
+unsigned int LevelPack::checksum(const std::vector<TileType> & tiles) {
+	unsigned int code = 2166136261u;
+	for (size_t k = 0; k < tiles.size(); k++) {
+		code = (code ^ (unsigned int)tiles[k]) * 16777619u;
+	}
+	return code;
+}
+
+int LevelPack::add(unsigned long long seed, int width, int height) {
+	LevelSeed level;
+	level.seed = seed;
+	level.width = width;
+	level.height = height;
+	level.tryTimes = tryTimes;
+	level.maxNodes = maxNodes;
+	std::vector<TileType> tiles;
+	int steps = generate(level, tiles);
+	level.checksum = checksum(tiles);
+	levels.push_back(level);
+	return steps;
+}
+
+int LevelPack::regenerate(int index, std::vector<TileType> & tiles) {
+	if (index < 0 || index >= (int)levels.size()) {
+		return -1;
+	}
+	LevelSeed level = levels[index];
+	if (level.hasDecisions) {
+		replay(level, tiles);
+	}
+	else {
+		generate(level, tiles);
+	}
+	if (checksum(tiles) != level.checksum) {
+		return -1;
+	}
+	// 汾1ļ¼ϽţٱʱͿԿ
+	levels[index] = level;
+	return level.steps;
+}
+
+bool LevelPack::load(const char * path) {
+	std::ifstream in(path, std::ios::binary);
+	if (!in) {
+		return false;
+	}
+	char magic[4];
+	int version = 0;
+	int count = 0;
+	in.read(magic, 4);
+	in.read((char *)&version, sizeof(version));
+	in.read((char *)&count, sizeof(count));
+	if (!in || magic[0] != FILE_MAGIC[0] || magic[1] != FILE_MAGIC[1] || magic[2] != FILE_MAGIC[2] || magic[3] != FILE_MAGIC[3] || version < 1 || version > FILE_VERSION || count < 0) {
+		return false;
+	}
+	levels.clear();
+	for (int k = 0; k < count; k++) {
+		// ֶζдļʽܽṹӰ
+		LevelSeed level;
+		unsigned short width, height, trytimes;
+		in.read((char *)&level.seed, sizeof(level.seed));
+		in.read((char *)&width, sizeof(width));
+		in.read((char *)&height, sizeof(height));
+		in.read((char *)&trytimes, sizeof(trytimes));
+		in.read((char *)&level.maxNodes, sizeof(level.maxNodes));
+		in.read((char *)&level.checksum, sizeof(level.checksum));
+		if (!in) {
+			return false;
+		}
+		level.width = width;
+		level.height = height;
+		level.tryTimes = trytimes;
+		level.steps = -1;
+		level.hasDecisions = false;
+		if (version >= 2) {
+			short steps;
+			unsigned short acceptnum;
+			in.read((char *)&steps, sizeof(steps));
+			in.read((char *)&acceptnum, sizeof(acceptnum));
+			// ÿνܶһǽһӺĿ㣬ܴᳬ
+			if (!in || (acceptnum != NO_DECISIONS && acceptnum > width * height)) {
+				return false;
+			}
+			level.steps = steps;
+			level.hasDecisions = acceptnum != NO_DECISIONS;
+			if (!level.hasDecisions) {
+				acceptnum = 0;
+			}
+			int candidatenum = -1;
+			for (int a = 0; a < acceptnum; a++) {
+				unsigned short gap;
+				in.read((char *)&gap, sizeof(gap));
+				// ν֮trytimesѡؿѽ
+				if (!in || gap < 1 || gap > trytimes) {
+					return false;
+				}
+				candidatenum += gap;
+				level.accepted.push_back(candidatenum);
+			}
+		}
+		levels.push_back(level);
+	}
+	return true;
+}
+
+bool LevelPack::save(const char * path) {
+	std::ofstream out(path, std::ios::binary | std::ios::trunc);
+	if (!out) {
+		return false;
+	}
+	int version = FILE_VERSION;
+	int count = (int)levels.size();
+	out.write(FILE_MAGIC, 4);
+	out.write((char *)&version, sizeof(version));
+	out.write((char *)&count, sizeof(count));
+	for (size_t k = 0; k < levels.size(); k++) {
+		const LevelSeed & level = levels[k];
+		unsigned short width = (unsigned short)level.width;
+		unsigned short height = (unsigned short)level.height;
+		unsigned short trytimes = (unsigned short)level.tryTimes;
+		out.write((char *)&level.seed, sizeof(level.seed));
+		out.write((char *)&width, sizeof(width));
+		out.write((char *)&height, sizeof(height));
+		out.write((char *)&trytimes, sizeof(trytimes));
+		out.write((char *)&level.maxNodes, sizeof(level.maxNodes));
+		out.write((char *)&level.checksum, sizeof(level.checksum));
+		short steps = (short)level.steps;
+		unsigned short acceptnum = level.hasDecisions ? (unsigned short)level.accepted.size() : NO_DECISIONS;
+		out.write((char *)&steps, sizeof(steps));
+		out.write((char *)&acceptnum, sizeof(acceptnum));
+		for (int a = 0; level.hasDecisions && a < acceptnum; a++) {
+			unsigned short gap = (unsigned short)(level.accepted[a] - (a > 0 ? level.accepted[a - 1] : -1));
+			out.write((char *)&gap, sizeof(gap));
+		}
+	}
+	return (bool)out;
+}
\ No newline at end of file
@@ -0,0 +1,50 @@
+#pragma once
+#include "TileType.h"
+#include <vector>
+
+// ؿеһ¼ֻɲؿҪʱGenerateLevel
+struct LevelSeed {
+	unsigned long long seed;
+	int width;
+	int height;
+	// ̰ʱʧܶٴκֹͣ
+	int tryTimes;
+	// ѡؿ״̬
+	int maxNodes;
+	// ɽУֵ㷨ı䵼½ͬʱԷ
+	unsigned int checksum;
+	// ̽ӴûеõнؿʱΪ-1
+	int steps;
+	// ̰бܵĺѡؿţʱطŶ⣻
+	// 汾1ļûһhasDecisionsΪfalseֻ
+	bool hasDecisions;
+	std::vector<int> accepted;
+};
+
+// ʽĹؿÿؿֻɲͱܵĺѡؿţ̱
+// 汾2ļ¼Ϊ26ֽڼÿ2ֽڣ8ֽڣߡʧܴ2ֽڣ
+// ״̬4ֽڣУֵ4ֽڣӴ2ֽڣܴ2ֽڣ֮ڽ֮
+// ܴΪ0xFFFFʾ¼Ӱ汾1롢ûн
+class LevelPack {
+public:
+	LevelPack();
+	~LevelPack();
+	std::vector<LevelSeed> levels;
+	// ¼ؿʹõɲ
+	int tryTimes;
+	int maxNodes;
+	// ¼еĲȷԵɹؿд¼Ӵͽţ
+	// ̽Ӵûеõнؿʱ-1
+	static int generate(LevelSeed & level, std::vector<TileType> & tiles);
+	// ¼еĽطɹ̣κ
+	static void replay(const LevelSeed & level, std::vector<TileType> & tiles);
+	static unsigned int checksum(const std::vector<TileType> & tiles);
+	// øһؿУ̽Ӵ
+	int add(unsigned long long seed, int width, int height);
+	// ɵindexؿԽУֵʱ-1
+	// нŵļ¼ֻطţ⣻汾1ļ¼ɣϽ
+	int regenerate(int index, std::vector<TileType> & tiles);
+	// ļȡؿļڻʽʱfalse
+	bool load(const char * path);
+	bool save(const char * path);
+};
\ No newline at end of file
@@ -0,0 +1,200 @@
+#include "pch.h"
+#include "LevelPool.h"
+#include "GenerateLevel.h"
+#include "Trace.h"
+#include <time.h>
+#include <windows.h>
+
+// Ѷ̰ʱʧܶٴκֹͣԽؿԽ
+static const int TRY_TIMES[D_NUM] = { 20, 60, 150 };
+// ʧܺͣʱBACKOFF_MIN뿪ʼÿμӱBACKOFF_MAX
+static const int BACKOFF_MIN = 1;
+static const int BACKOFF_MAX = 300;
+
+LevelPool::LevelPool(const PoolOptions & options) {
+	this->options = options;
+	generatedNum = 0;
+	discardedNum = 0;
+	stopping = false;
+	nextseed = options.seed != 0 ? options.seed : (unsigned long long)time(NULL);
+	int poolnum = (options.maxSize - options.minSize + 1) * D_NUM;
+	pools.resize(poolnum);
+	pending.assign(poolnum, 0);
+	misses.assign(poolnum, 0);
+	retryAt.assign(poolnum, std::chrono::steady_clock::time_point());
+}
+
+LevelPool::~LevelPool() {
+	stop();
+}
+
+void LevelPool::start() {
+	stopping = false;
+	for (int k = 0; k < options.workers; k++) {
+		threads.push_back(std::thread(&LevelPool::work, this));
+	}
+}
+
+void LevelPool::stop() {
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		stopping = true;
+	}
+	refill.notify_all();
+	for (size_t k = 0; k < threads.size(); k++) {
+		threads[k].join();
+	}
+	threads.clear();
+}
+
+int LevelPool::poolIndex(int width, int height, int difficulty) {
+	if (width != height || width < options.minSize || width > options.maxSize || difficulty < 0 || difficulty >= D_NUM) {
+		return -1;
+	}
+	return (width - options.minSize) * D_NUM + difficulty;
+}
+
+Difficulty LevelPool::classify(int steps) {
+	if (steps >= options.hardSteps) {
+		return D_HARD;
+	}
+	if (steps >= options.mediumSteps) {
+		return D_MEDIUM;
+	}
+	return D_EASY;
+}
+
+int LevelPool::neediest(std::chrono::steady_clock::time_point now) {
+	int best = -1;
+	int bestdeficit = 0;
+	for (int k = 0; k < (int)pools.size(); k++) {
+		// ÿͬʱֻһ̲߳䣬ɵĳزռ߳
+		if (pending[k] > 0 || now < retryAt[k]) {
+			continue;
+		}
+		int deficit = options.capacity - (int)pools[k].size();
+		if (deficit > bestdeficit) {
+			best = k;
+			bestdeficit = deficit;
+		}
+	}
+	return best;
+}
+
+std::chrono::steady_clock::time_point LevelPool::nextRetry() {
+	// maxţⱻwindows.hmaxչ
+	std::chrono::steady_clock::time_point retry = (std::chrono::steady_clock::time_point::max)();
+	for (int k = 0; k < (int)pools.size(); k++) {
+		if (pending[k] == 0 && misses[k] > 0 && (int)pools[k].size() < options.capacity && retryAt[k] < retry) {
+			retry = retryAt[k];
+		}
+	}
+	return retry;
+}
+
+bool LevelPool::take(int width, int height, int difficulty, PooledLevel & level) {
+	TRACE_SCOPE("LevelPool::take");
+	std::lock_guard<std::mutex> guard(lock);
+	int index = -1;
+	if (difficulty < 0) {
+		for (int d = D_NUM - 1; d >= 0 && index < 0; d--) {
+			int k = poolIndex(width, height, d);
+			if (k >= 0 && pools[k].size() > 0) {
+				index = k;
+			}
+		}
+	}
+	else {
+		index = poolIndex(width, height, difficulty);
+	}
+	if (index < 0 || pools[index].size() == 0) {
+		return false;
+	}
+	level = pools[index].front();
+	pools[index].pop_front();
+	refill.notify_one();
+	return true;
+}
+
+int LevelPool::count(int width, int height, int difficulty) {
+	std::lock_guard<std::mutex> guard(lock);
+	int index = poolIndex(width, height, difficulty);
+	return index < 0 ? 0 : (int)pools[index].size();
+}
+
+void LevelPool::work() {
+	TRACE_THREAD_NAME("LevelPool::worker");
+	// ߳̽ȼ֤߳ʱӦ
+	SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL);
+	while (true) {
+		int index = -1;
+		unsigned long long seed;
+		{
+			std::unique_lock<std::mutex> guard(lock);
+			while (!stopping && (index = neediest(std::chrono::steady_clock::now())) < 0) {
+				// ȱڶͣеĳʱȵͣȡ߹ؿֹͣʱҲᱻ
+				std::chrono::steady_clock::time_point retry = nextRetry();
+				if (retry == (std::chrono::steady_clock::time_point::max)()) {
+					refill.wait(guard);
+				}
+				else {
+					refill.wait_until(guard, retry);
+				}
+			}
+			if (stopping) {
+				return;
+			}
+			pending[index]++;
+			seed = nextseed++;
+		}
+		int size = options.minSize + index / D_NUM;
+		int difficulty = index % D_NUM;
+		PooledLevel level;
+		level.width = size;
+		level.height = size;
+		level.seed = seed;
+		level.tryTimes = TRY_TIMES[difficulty];
+		level.maxNodes = options.maxNodes;
+		{
+			TRACE_SCOPE("LevelPool::generate");
+			GenerateLevel gl(size, size, seed);
+			SolveLimits limits;
+			limits.maxNodes = options.maxNodes;
+			// ֹͣʱڽе⾡췵
+			limits.cancel = &stopping;
+			level.steps = gl.generate(level.tryTimes, limits);
+			level.tiles.assign(gl.tiles, gl.tiles + size * size);
+		}
+		std::lock_guard<std::mutex> guard(lock);
+		pending[index]--;
+		// ֿ̲߳
+		refill.notify_one();
+		if (stopping) {
+			continue;
+		}
+		int target = level.steps < 1 ? -1 : poolIndex(size, size, classify(level.steps));
+		if (target != index) {
+			// ûɳĿѶȵĹؿͣأһֱɵĳϿת
+			misses[index]++;
+			int backoff = BACKOFF_MIN;
+			for (int k = 1; k < misses[index] && backoff < BACKOFF_MAX; k++) {
+				backoff *= 2;
+			}
+			retryAt[index] = std::chrono::steady_clock::now() + std::chrono::seconds(backoff < BACKOFF_MAX ? backoff : BACKOFF_MAX);
+		}
+		if (target < 0) {
+			continue;
+		}
+		// ɳصĹؿȡͣ
+		misses[target] = 0;
+		retryAt[target] = std::chrono::steady_clock::time_point();
+		generatedNum++;
+		// ɽѶȲһĿѶȣŽʵѶȶӦĳ
+		if ((int)pools[target].size() < options.capacity) {
+			pools[target].push_back(level);
+		}
+		else {
+			discardedNum++;
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,85 @@
+#pragma once
+#include "TileType.h"
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+// Ѷȵȼ̽Ӵ
+enum Difficulty {
+	D_EASY,
+	D_MEDIUM,
+	D_HARD,
+	D_NUM
+};
+// ԤɺõĹؿ
+struct PooledLevel {
+	int width;
+	int height;
+	std::vector<TileType> tiles;
+	// ̽Ӵ
+	int steps;
+	// ӣͬĳߴ硢ӡtryTimesmaxNodesGenerateLevel::generateͬһؿ
+	unsigned long long seed;
+	// ̰ʱʧܶٴκֹͣԼѡؿ״̬
+	int tryTimes;
+	int maxNodes;
+};
+// ؿصĲ
+struct PoolOptions {
+	// ֻ֧̣߳minSizemaxSize
+	int minSize = 6;
+	int maxSize = 11;
+	// ÿߴ硢ÿѶȵĳౣĹؿ
+	int capacity = 8;
+	int workers = 2;
+	// ӴmediumStepsΪеѶȣhardStepsΪ
+	int mediumSteps = 8;
+	int hardSteps = 16;
+	// ѡؿ״̬
+	int maxNodes = 300000;
+	// һؿӣ֮μһ
+	unsigned long long seed = 0;
+};
+// ԤɹؿأߴѶȷֳɶأ̨̲߳ɹؿȱĳأ
+// ȡ߹ؿ̨֪̲ͨ߳䣬ȡؿֻҪӡ
+// ɳĳѶȵĳأ6x6ѹؿʧܺͣһʱ䣬ʧԽͣԽá
+class LevelPool {
+public:
+	LevelPool(const PoolOptions & options);
+	// ʱֹͣȴ̨߳
+	~LevelPool();
+	void start();
+	// ȡڽеⲢȴ̨߳̽
+	void stop();
+	// ȡһؿdifficultyΪ-1ʱȡеѹؿûйؿʱfalse
+	bool take(int width, int height, int difficulty, PooledLevel & level);
+	// еĹؿ
+	int count(int width, int height, int difficulty);
+	Difficulty classify(int steps);
+	PoolOptions options;
+	// ɵнؿԼΪӦĳĹؿ
+	std::atomic<int> generatedNum;
+	std::atomic<int> discardedNum;
+private:
+	void work();
+	// صţߴ粻֧ʱ-1
+	int poolIndex(int width, int height, int difficulty);
+	// ȱû߳ڲҲͣеĳأûĳʱ-1
+	int neediest(std::chrono::steady_clock::time_point now);
+	// δĳͣʱ䣬ûͣеĳʱtime_point::max()
+	std::chrono::steady_clock::time_point nextRetry();
+	std::vector<std::deque<PooledLevel> > pools;
+	// ÿڲ߳
+	std::vector<int> pending;
+	// ÿʧܵĴԼͣʲôʱ
+	std::vector<int> misses;
+	std::vector<std::chrono::steady_clock::time_point> retryAt;
+	std::vector<std::thread> threads;
+	std::mutex lock;
+	std::condition_variable refill;
+	std::atomic<bool> stopping;
+	unsigned long long nextseed;
+};
\ No newline at end of file
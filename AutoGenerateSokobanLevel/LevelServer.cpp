@@ -0,0 +1,252 @@
+#include "pch.h"
+#include "LevelServer.h"
+#include "Trace.h"
+#include <winsock2.h>
+#include <windows.h>
+#include <sstream>
+#include <map>
+#include <cstring>
+#include <cstdlib>
+#pragma comment(lib, "ws2_32.lib")
+
+// TileType˳еXSBַ
+static const char XSB_CHARS[] = ".$*@+# ";
+static const char * DIFFICULTY_NAMES[D_NUM] = { "easy", "medium", "hard" };
+// ͷ󳤶
+static const int MAX_REQUEST = 8192;
+
+LevelServer::LevelServer(LevelPool * pool, int port) {
+	this->pool = pool;
+	this->port = port;
+	requestNum = 0;
+	listener = (std::uintptr_t)INVALID_SOCKET;
+	stopping = false;
+}
+
+LevelServer::~LevelServer() {
+}
+
+static std::string response(const char * status, const std::string & body) {
+	std::ostringstream out;
+	out << "HTTP/1.1 " << status << "\r\n"
+		<< "Content-Type: application/json; charset=utf-8\r\n"
+		// ҳֱӴļ򿪣Ҫȡ
+		<< "Access-Control-Allow-Origin: *\r\n"
+		<< "Cache-Control: no-store\r\n"
+		<< "Content-Length: " << body.size() << "\r\n"
+		<< "Connection: close\r\n\r\n"
+		<< body;
+	return out.str();
+}
+
+// Ŀ?֮Ĳ
+static std::map<std::string, std::string> parseQuery(const std::string & target) {
+	std::map<std::string, std::string> query;
+	size_t pos = target.find('?');
+	while (pos != std::string::npos) {
+		size_t end = target.find('&', pos + 1);
+		std::string pair = target.substr(pos + 1, end == std::string::npos ? std::string::npos : end - pos - 1);
+		size_t eq = pair.find('=');
+		if (eq != std::string::npos) {
+			query[pair.substr(0, eq)] = pair.substr(eq + 1);
+		}
+		pos = end;
+	}
+	return query;
+}
+
+std::string LevelServer::levelJson(const PooledLevel & level) {
+	std::ostringstream out;
+	out << "{\"width\":" << level.width << ",\"height\":" << level.height
+		<< ",\"steps\":" << level.steps << ",\"seed\":" << level.seed
+		<< ",\"tryTimes\":" << level.tryTimes << ",\"maxNodes\":" << level.maxNodes << ",\"rows\":[";
+	for (int i = 0; i < level.height; i++) {
+		out << (i > 0 ? ",\"" : "\"");
+		for (int j = 0; j < level.width; j++) {
+			out << XSB_CHARS[level.tiles[i * level.width + j]];
+		}
+		out << "\"";
+	}
+	out << "]}";
+	return out.str();
+}
+
+std::string LevelServer::statusJson() {
+	std::ostringstream out;
+	out << "{\"generated\":" << pool->generatedNum.load() << ",\"discarded\":" << pool->discardedNum.load()
+		<< ",\"requests\":" << requestNum.load() << ",\"pools\":[";
+	for (int size = pool->options.minSize; size <= pool->options.maxSize; size++) {
+		for (int d = 0; d < D_NUM; d++) {
+			out << (size == pool->options.minSize && d == 0 ? "" : ",")
+				<< "{\"width\":" << size << ",\"height\":" << size << ",\"difficulty\":\"" << DIFFICULTY_NAMES[d]
+				<< "\",\"count\":" << pool->count(size, size, d) << "}";
+		}
+	}
+	out << "]}";
+	return out.str();
+}
+
+std::string LevelServer::handle(const std::string & request) {
+	TRACE_SCOPE("LevelServer::handle");
+	requestNum++;
+	std::istringstream line(request);
+	std::string method, target;
+	line >> method >> target;
+	if (method != "GET") {
+		return response("405 Method Not Allowed", "{\"error\":\"method not allowed\"}");
+	}
+	std::string path = target.substr(0, target.find('?'));
+	if (path == "/status") {
+		return response("200 OK", statusJson());
+	}
+	if (path != "/level") {
+		return response("404 Not Found", "{\"error\":\"not found\"}");
+	}
+	std::map<std::string, std::string> query = parseQuery(target);
+	int width = query.count("w") ? atoi(query["w"].c_str()) : 8;
+	int height = query.count("h") ? atoi(query["h"].c_str()) : width;
+	int difficulty = -1;
+	if (query.count("difficulty")) {
+		for (int d = 0; d < D_NUM; d++) {
+			if (query["difficulty"] == DIFFICULTY_NAMES[d]) {
+				difficulty = d;
+			}
+		}
+		if (difficulty < 0) {
+			return response("400 Bad Request", "{\"error\":\"unknown difficulty\"}");
+		}
+	}
+	PooledLevel level;
+	if (!pool->take(width, height, difficulty, level)) {
+		// ʱûйؿͻӦԼ
+		return response("503 Service Unavailable", "{\"error\":\"pool empty\"}");
+	}
+	return response("200 OK", levelJson(level));
+}
+
+bool LevelServer::run() {
+	WSADATA wsadata;
+	if (WSAStartup(MAKEWORD(2, 2), &wsadata) != 0) {
+		return false;
+	}
+	SOCKET s = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if (s == INVALID_SOCKET) {
+		WSACleanup();
+		return false;
+	}
+	sockaddr_in addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	addr.sin_port = htons((u_short)port);
+	if (bind(s, (sockaddr *)&addr, sizeof(addr)) == SOCKET_ERROR || listen(s, SOMAXCONN) == SOCKET_ERROR) {
+		closesocket(s);
+		WSACleanup();
+		return false;
+	}
+	// ȼ¼׽ټstopping֮ŵõstop()رʹaccept()
+	listener = (std::uintptr_t)s;
+	for (int k = 0; k < HANDLER_THREADS; k++) {
+		handlers.push_back(std::thread(&LevelServer::serve, this));
+	}
+	int failures = 0;
+	while (!stopping) {
+		SOCKET client = accept(s, NULL, NULL);
+		if (client == INVALID_SOCKET) {
+			if (stopping) {
+				break;
+			}
+			// ʧʱӳȴһ룬תռCPU
+			failures++;
+			Sleep(failures < 7 ? 10 << failures : 1000);
+			continue;
+		}
+		failures = 0;
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			if ((int)connections.size() < MAX_PENDING) {
+				connections.push_back((std::uintptr_t)client);
+				arrived.notify_one();
+				continue;
+			}
+		}
+		closesocket(client);
+	}
+	closeListener();
+	arrived.notify_all();
+	for (size_t k = 0; k < handlers.size(); k++) {
+		handlers[k].join();
+	}
+	handlers.clear();
+	// ֹͣûüֱӹر
+	for (size_t k = 0; k < connections.size(); k++) {
+		closesocket((SOCKET)connections[k]);
+	}
+	connections.clear();
+	WSACleanup();
+	return true;
+}
+
+void LevelServer::serve() {
+	TRACE_THREAD_NAME("LevelServer::handler");
+	while (true) {
+		std::uintptr_t client;
+		{
+			std::unique_lock<std::mutex> guard(lock);
+			arrived.wait(guard, [&] { return stopping || connections.size() > 0; });
+			if (stopping) {
+				return;
+			}
+			client = connections.front();
+			connections.pop_front();
+		}
+		respond(client);
+	}
+}
+
+void LevelServer::respond(std::uintptr_t connection) {
+	SOCKET client = (SOCKET)connection;
+	// ռһ߳һ
+	DWORD timeout = 1000;
+	setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, (const char *)&timeout, sizeof(timeout));
+	int nodelay = 1;
+	setsockopt(client, IPPROTO_TCP, TCP_NODELAY, (const char *)&nodelay, sizeof(nodelay));
+	std::string request;
+	char buffer[1024];
+	while (request.find("\r\n\r\n") == std::string::npos && (int)request.size() < MAX_REQUEST) {
+		int len = recv(client, buffer, sizeof(buffer), 0);
+		if (len <= 0) {
+			break;
+		}
+		request.append(buffer, len);
+	}
+	if (request.size() > 0) {
+		std::string reply = handle(request);
+		size_t sent = 0;
+		while (sent < reply.size()) {
+			int len = send(client, reply.data() + sent, (int)(reply.size() - sent), 0);
+			if (len <= 0) {
+				break;
+			}
+			sent += len;
+		}
+	}
+	closesocket(client);
+}
+
+void LevelServer::closeListener() {
+	SOCKET s = (SOCKET)listener.exchange((std::uintptr_t)INVALID_SOCKET);
+	if (s != INVALID_SOCKET) {
+		closesocket(s);
+	}
+}
+
+void LevelServer::stop() {
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		stopping = true;
+	}
+	arrived.notify_all();
+	// رռ׽ʹеaccept()
+	closeListener();
+}
\ No newline at end of file
@@ -0,0 +1,50 @@
+#pragma once
+#include "LevelPool.h"
+#include <string>
+#include <cstdint>
+#include <atomic>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+// HTTPؿֻ127.0.0.1ֱӴӹؿȡԤɺõĹؿ
+// ʱκɻ⡣
+//   GET /level?w=8&h=8&difficulty=easy|medium|hard  һؿûʱ503
+//   GET /status                                     ظеĹؿ
+// ֻ߳ӣӽ̣߳ٿͻ˲
+class LevelServer {
+public:
+	LevelServer(LevelPool * pool, int port);
+	~LevelServer();
+	// ֱstop()ǰرռ׽ֲȴ߳̽޷˿ʱfalse
+	bool run();
+	// ߳еą̃ƴ
+	void stop();
+	// һHTTP󣬷Ӧ
+	std::string handle(const std::string & request);
+	// ؿJSONʾ̵ÿһXSBַʾ
+	static std::string levelJson(const PooledLevel & level);
+	int port;
+	std::atomic<int> requestNum;
+	// ͬʱӵ߳
+	static const int HANDLER_THREADS = 4;
+	// ȴޣʱֱӹر
+	static const int MAX_PENDING = 64;
+private:
+	std::string statusJson();
+	// ̣߳ȡӣȡӦ
+	void serve();
+	void respond(std::uintptr_t connection);
+	// رռ׽֣run()stop()ܵãֻеһЧ
+	void closeListener();
+	LevelPool * pool;
+	// õWinsock SOCKETͷļвwinsock2.h
+	std::atomic<std::uintptr_t> listener;
+	std::atomic<bool> stopping;
+	// ѽܡȴ߳Ӧ
+	std::deque<std::uintptr_t> connections;
+	std::vector<std::thread> handlers;
+	std::mutex lock;
+	std::condition_variable arrived;
+};
\ No newline at end of file
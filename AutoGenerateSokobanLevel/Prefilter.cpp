@@ -0,0 +1,107 @@
+#include "pch.h"
+#include "Prefilter.h"
+#include "Trace.h"
+
+Prefilter::Prefilter(State * state) {
+	width = state->width;
+	height = state->height;
+	tiles = state->tiles;
+	for (int k = 0; k < width * height; k++) {
+		if (tiles[k] == Box || tiles[k] == BoxinAid) {
+			boxes.push_back(k);
+		}
+		if (tiles[k] == Aid || tiles[k] == BoxinAid || tiles[k] == CharacterinAid) {
+			goals.push_back(k);
+		}
+	}
+	reach.assign(goals.size() * width * height, 0);
+	for (int g = 0; g < (int)goals.size(); g++) {
+		pullFromGoal(g);
+	}
+}
+
+Prefilter::~Prefilter() {
+}
+
+bool Prefilter::run() {
+	TRACE_SCOPE("Prefilter::run");
+	// ûӵĹؿSolverԭĹ
+	if (boxes.size() == 0 && goals.size() == 0) {
+		return true;
+	}
+	return ifCountMatch() && !ifBoxOnDeadSquare() && ifMatchable();
+}
+
+bool Prefilter::ifCountMatch() {
+	return boxes.size() == goals.size();
+}
+
+void Prefilter::pullFromGoal(int g) {
+	char * mark = &reach[g * width * height];
+	std::vector<int> stack;
+	stack.push_back(goals[g]);
+	mark[goals[g]] = 1;
+	while (stack.size() > 0) {
+		int loc = stack.back();
+		stack.pop_back();
+		int li = loc / width;
+		int lj = loc % width;
+		int di[4] = { -1, 1, 0, 0 };
+		int dj[4] = { 0, 0, -1, 1 };
+		for (int d = 0; d < 4; d++) {
+			// Ӵ(pi, pj)Ƶǰӣ֮ǰվ(qi, qj)
+			int pi = li + di[d];
+			int pj = lj + dj[d];
+			int qi = li + 2 * di[d];
+			int qj = lj + 2 * dj[d];
+			if (qi < 0 || qj < 0 || qi >= height || qj >= width) {
+				continue;
+			}
+			int p = pi * width + pj;
+			int q = qi * width + qj;
+			if (tiles[p] == Wall || tiles[q] == Wall || mark[p]) {
+				continue;
+			}
+			mark[p] = 1;
+			stack.push_back(p);
+		}
+	}
+}
+
+bool Prefilter::ifBoxOnDeadSquare() {
+	for (int b = 0; b < (int)boxes.size(); b++) {
+		bool alive = false;
+		for (int g = 0; g < (int)goals.size() && !alive; g++) {
+			alive = reach[g * width * height + boxes[b]] != 0;
+		}
+		if (!alive) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool Prefilter::augment(int b, std::vector<int> & goalmatch, std::vector<char> & used) {
+	for (int g = 0; g < (int)goals.size(); g++) {
+		if (used[g] || !reach[g * width * height + boxes[b]]) {
+			continue;
+		}
+		used[g] = 1;
+		if (goalmatch[g] < 0 || augment(goalmatch[g], goalmatch, used)) {
+			goalmatch[g] = b;
+			return true;
+		}
+	}
+	return false;
+}
+
+bool Prefilter::ifMatchable() {
+	std::vector<int> goalmatch(goals.size(), -1);
+	for (int b = 0; b < (int)boxes.size(); b++) {
+		std::vector<char> used(goals.size(), 0);
+		if (!augment(b, goalmatch, used)) {
+			return false;
+		}
+	}
+	return true;
+}
\ No newline at end of file
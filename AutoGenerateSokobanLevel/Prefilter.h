@@ -0,0 +1,30 @@
+#pragma once
+#include "State.h"
+#include <vector>
+// ֮ǰĿԤ飺ֻؿнıҪ
+// ʱؿһ޽⣬Solver
+class Prefilter {
+public:
+	Prefilter(State * state);
+	~Prefilter();
+	// бҪʱtrue
+	bool run();
+	// ĿǷ
+	bool ifCountMatch();
+	// Ƿλ񣨴κĿ㶼ĸӣ
+	bool ifBoxOnDeadSquare();
+	// ǷӵĿƥ䣬ÿֻƥƵõĿ
+	bool ifMatchable();
+	int width;
+	int height;
+	TileType * tiles;
+	std::vector<int> boxes;
+	std::vector<int> goals;
+	// reach[g * width * height + k]ʱkϵܷƵgĿ
+	std::vector<char> reach;
+private:
+	// ĿӣܰƵĿи
+	void pullFromGoal(int g);
+	// 㷨·
+	bool augment(int b, std::vector<int> & goalmatch, std::vector<char> & used);
+};
\ No newline at end of file
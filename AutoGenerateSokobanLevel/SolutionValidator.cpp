@@ -0,0 +1,268 @@
+#include "pch.h"
+#include "SolutionValidator.h"
+#include "Trace.h"
+#include <thread>
+#include <chrono>
+#include <algorithm>
+
+// ÿı־λ
+static const unsigned char C_WALL = 1;
+static const unsigned char C_GOAL = 2;
+static const unsigned char C_BOX = 4;
+
+SolutionValidator::SolutionValidator(int threads) {
+	this->threads = threads > 0 ? threads : 1;
+	batchSize = 4096;
+	maxFailures = 1000;
+	levelNum = 0;
+	passNum = 0;
+	moveNum = 0;
+	pushNum = 0;
+	elapsed = 0;
+	for (int k = 0; k < V_NUM; k++) {
+		errorNum[k] = 0;
+	}
+	finished = false;
+}
+
+SolutionValidator::~SolutionValidator() {
+}
+
+double SolutionValidator::movesPerSecond() {
+	return elapsed > 0 ? moveNum / elapsed : 0;
+}
+
+ValidationResult SolutionValidator::validate(const ValidationRecord & record) {
+	ValidationResult result;
+	result.index = record.index;
+	result.name = record.name;
+	result.error = V_OK;
+	result.errorMove = -1;
+	result.moves = 0;
+	result.pushes = 0;
+	// תΪ̣ܸһȦǽڣƶʱüԽ
+	int height = (int)record.rows.size() + 2;
+	int width = 0;
+	for (size_t r = 0; r < record.rows.size(); r++) {
+		width = std::max(width, (int)record.rows[r].size());
+	}
+	width += 2;
+	std::vector<unsigned char> cells(width * height, C_WALL);
+	int player = -1;
+	int playernum = 0;
+	int boxnum = 0;
+	int goalnum = 0;
+	// ĿϵΪ0ʱؿ
+	int loosenum = 0;
+	for (size_t r = 0; r < record.rows.size(); r++) {
+		const std::string & row = record.rows[r];
+		for (size_t c = 0; c < row.size(); c++) {
+			int loc = ((int)r + 1) * width + (int)c + 1;
+			unsigned char cell = 0;
+			switch (row[c]) {
+			case '#':
+				cell = C_WALL;
+				break;
+			case '$':
+				cell = C_BOX;
+				break;
+			case '.':
+				cell = C_GOAL;
+				break;
+			case '*':
+				cell = C_BOX | C_GOAL;
+				break;
+			case '@':
+				player = loc;
+				playernum++;
+				break;
+			case '+':
+				cell = C_GOAL;
+				player = loc;
+				playernum++;
+				break;
+			default:
+				break;
+			}
+			cells[loc] = cell;
+			boxnum += (cell & C_BOX) ? 1 : 0;
+			goalnum += (cell & C_GOAL) ? 1 : 0;
+			loosenum += cell == C_BOX ? 1 : 0;
+		}
+	}
+	if (playernum != 1 || boxnum != goalnum) {
+		result.error = V_BADLEVEL;
+		return result;
+	}
+	const std::string & solution = record.solution;
+	for (size_t m = 0; m < solution.size(); m++) {
+		int offset;
+		switch (solution[m]) {
+		case 'u': case 'U':
+			offset = -width;
+			break;
+		case 'd': case 'D':
+			offset = width;
+			break;
+		case 'l': case 'L':
+			offset = -1;
+			break;
+		case 'r': case 'R':
+			offset = 1;
+			break;
+		default:
+			result.error = V_BADMOVE;
+			result.errorMove = (int)m;
+			return result;
+		}
+		bool ifpush = solution[m] < 'a';
+		int next = player + offset;
+		if (cells[next] & C_WALL) {
+			result.error = V_BLOCKED;
+		}
+		else if (ifpush != ((cells[next] & C_BOX) != 0)) {
+			result.error = V_PUSHFLAG;
+		}
+		else if (ifpush) {
+			int next2 = next + offset;
+			if (cells[next2] & (C_WALL | C_BOX)) {
+				result.error = V_BLOCKED;
+			}
+			else {
+				loosenum -= (cells[next] & C_GOAL) ? 0 : 1;
+				loosenum += (cells[next2] & C_GOAL) ? 0 : 1;
+				cells[next] &= ~C_BOX;
+				cells[next2] |= C_BOX;
+				result.pushes++;
+			}
+		}
+		if (result.error != V_OK) {
+			result.errorMove = (int)m;
+			return result;
+		}
+		player = next;
+		result.moves++;
+	}
+	if (loosenum > 0) {
+		result.error = V_UNSOLVED;
+	}
+	return result;
+}
+
+// űȽʧܼ¼
+static bool indexLess(const ValidationResult & a, const ValidationResult & b) {
+	return a.index < b.index;
+}
+
+void SolutionValidator::collect(std::vector<ValidationResult> & results) {
+	std::lock_guard<std::mutex> guard(lock);
+	for (size_t k = 0; k < results.size(); k++) {
+		ValidationResult & result = results[k];
+		levelNum++;
+		moveNum += result.moves;
+		pushNum += result.pushes;
+		errorNum[result.error]++;
+		if (result.error == V_OK) {
+			passNum++;
+		}
+		else if ((int)failures.size() < maxFailures) {
+			failures.push_back(result);
+			std::push_heap(failures.begin(), failures.end(), indexLess);
+		}
+		else if (maxFailures > 0 && result.index < failures.front().index) {
+			// ɵ˳򲻶滻ѱһձСmaxFailures
+			std::pop_heap(failures.begin(), failures.end(), indexLess);
+			failures.back() = result;
+			std::push_heap(failures.begin(), failures.end(), indexLess);
+		}
+	}
+}
+
+void SolutionValidator::work() {
+	TRACE_THREAD_NAME("SolutionValidator::worker");
+	std::vector<ValidationResult> results;
+	while (true) {
+		std::vector<ValidationRecord> * batch;
+		{
+			std::unique_lock<std::mutex> guard(lock);
+			notempty.wait(guard, [&] { return finished || batches.size() > 0; });
+			if (batches.size() == 0) {
+				return;
+			}
+			batch = batches.front();
+			batches.pop_front();
+		}
+		notfull.notify_one();
+		{
+			TRACE_SCOPE("SolutionValidator::batch");
+			results.clear();
+			for (size_t k = 0; k < batch->size(); k++) {
+				results.push_back(validate((*batch)[k]));
+			}
+		}
+		delete batch;
+		collect(results);
+	}
+}
+
+long long SolutionValidator::run(std::istream & in) {
+	TRACE_SCOPE("SolutionValidator::run");
+	std::chrono::steady_clock::time_point starttime = std::chrono::steady_clock::now();
+	finished = false;
+	std::vector<std::thread> workers;
+	for (int k = 0; k < threads; k++) {
+		workers.push_back(std::thread(&SolutionValidator::work, this));
+	}
+	std::vector<ValidationRecord> * batch = new std::vector<ValidationRecord>();
+	ValidationRecord record;
+	record.index = 0;
+	long long recordnum = 0;
+	std::string line;
+	bool ifeof = false;
+	while (!ifeof) {
+		ifeof = !std::getline(in, line);
+		if (!ifeof && line.size() > 0 && line[line.size() - 1] == '\r') {
+			line.erase(line.size() - 1);
+		}
+		if (!ifeof && line.find_first_not_of(" \t") != std::string::npos) {
+			if (line[0] == ';') {
+				record.name = line.substr(1);
+			}
+			else if (line.find('#') != std::string::npos) {
+				record.rows.push_back(line);
+			}
+			else {
+				// ֳܷɶУеķǷַ֤ʱ
+				record.solution += line;
+			}
+			continue;
+		}
+		// лļһ¼
+		if (record.rows.size() > 0) {
+			record.index = recordnum++;
+			batch->push_back(std::move(record));
+			if ((int)batch->size() >= batchSize) {
+				std::unique_lock<std::mutex> guard(lock);
+				notfull.wait(guard, [&] { return (int)batches.size() < threads * 2; });
+				batches.push_back(batch);
+				notempty.notify_one();
+				batch = new std::vector<ValidationRecord>();
+			}
+		}
+		record.name.clear();
+		record.rows.clear();
+		record.solution.clear();
+	}
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		batches.push_back(batch);
+		finished = true;
+	}
+	notempty.notify_all();
+	for (size_t k = 0; k < workers.size(); k++) {
+		workers[k].join();
+	}
+	std::sort_heap(failures.begin(), failures.end(), indexLess);
+	elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - starttime).count();
+	return passNum;
+}
\ No newline at end of file
@@ -0,0 +1,78 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <deque>
+#include <istream>
+#include <mutex>
+#include <condition_variable>
+// ֤ʧܵԭ
+enum ValidationError {
+	V_OK,
+	// ؿʽûжĿ
+	V_BADLEVEL,
+	// LURDַ
+	V_BADMOVE,
+	// ߽ǽڣƶǰǽڻ
+	V_BLOCKED,
+	// СдǷӲдʾӣСдʾֻƶ
+	V_PUSHFLAG,
+	// ִӲĿ
+	V_UNSOLVED,
+	V_NUM
+};
+// еһ¼XSBʽĹؿкһLURDʽĽ
+struct ValidationRecord {
+	// еţ0ʼ
+	long long index;
+	// ؿ֮ǰ;ͷעУΪؿ
+	std::string name;
+	std::vector<std::string> rows;
+	std::string solution;
+};
+struct ValidationResult {
+	long long index;
+	std::string name;
+	ValidationError error;
+	// ʱǽĵڼ0ʼΪ-1
+	int errorMove;
+	int moves;
+	int pushes;
+};
+// ֤ؿĽ⣺̰߳жȡ벢зֳ̰߳ѹؿתΪ̺طŽ⡣
+// ÿһֽڣǽ/Ŀ/־λһȦǽڣһֻӡ
+// ʽؿ֮ÿзָ#ǹؿУֻLURDlurdǽ⣬;ͷǹؿ
+class SolutionValidator {
+public:
+	SolutionValidator(int threads);
+	~SolutionValidator();
+	// ȡ֤еȫ¼ͨļ¼
+	long long run(std::istream & in);
+	// ֤һ¼
+	static ValidationResult validate(const ValidationRecord & record);
+	int threads;
+	// ÿļ¼
+	int batchSize;
+	// ౣʧܼ¼ֻ
+	int maxFailures;
+	long long levelNum;
+	long long passNum;
+	long long moveNum;
+	long long pushNum;
+	// ֤ʱ룩
+	double elapsed;
+	double movesPerSecond();
+	// ʧԭļ¼
+	long long errorNum[V_NUM];
+	// СmaxFailuresʧܼ¼Уrun()Ϊ
+	std::vector<ValidationResult> failures;
+private:
+	void work();
+	// һĽ
+	void collect(std::vector<ValidationResult> & results);
+	// ֤ౣthreads * 2ȡ֤ʱ̵߳ȴ
+	std::deque<std::vector<ValidationRecord> *> batches;
+	std::mutex lock;
+	std::condition_variable notempty;
+	std::condition_variable notfull;
+	bool finished;
+};
\ No newline at end of file
@@ -1,80 +1,288 @@
 #include "pch.h"
 #include "Solver.h"
+#include "Trace.h"
 #include <iostream>
+#include <chrono>
+#include <cmath>
+// λ״̬ģʽÿ״̬ʹõĹϣλ
+static const int MAX_BIT_HASHES = 16;
 Solver::Solver(State* state)
 {
 	width = state->width;
 	height = state->height;
-	statenodes = new StateNode*[height * width];
-	statenodesamount = new int[height * width];
+	// ʼͰȡС̸2ݣ֮״̴̬С޹
+	bucketnum = 1;
+	while (bucketnum < height * width) {
+		bucketnum *= 2;
+	}
+	statenum = 0;
+	iterNum = 0;
+	expandedNum = 0;
+	solutionDepth = -1;
+	omissionExpected = 0;
+	bitnum = 0;
+	bithashnum = 0;
+	bitsetnum = 0;
+	checkpoint = nullptr;
+	checkpointinterval = 0;
+	statenodes = new StateNode*[bucketnum];
+	statenodesamount = new int[bucketnum];
 	State * newstate = state->clone();
-	for (int i = 0; i < height; i++) {
-		for (int j = 0; j < width; j++) {
-			statenodes[i * width + j] = new StateNode();
-			statenodesamount[i * width + j] = 0;
-		}
+	for (int i = 0; i < bucketnum; i++) {
+		statenodes[i] = nullptr;
+		statenodesamount[i] = 0;
 	}
 	newstate->charFloodFill();
 	unexploidlist.push_back(addState(newstate));
 }
 Solver::~Solver() {
-	for (int i = 0; i < height; i++) {
-		for (int j = 0; j < width; j++) {
-			statenodes[i * width + j]->deleteNode();
-			delete statenodes[i * width + j];
+	clear();
+	delete[] statenodes;
+	delete[] statenodesamount;
+	if (checkpoint != nullptr) {
+		delete checkpoint;
+	}
+}
+
+void Solver::clear() {
+	for (int i = 0; i < bucketnum; i++) {
+		if (statenodes[i] != nullptr) {
+			statenodes[i]->deleteNode();
+			delete statenodes[i];
+			statenodes[i] = nullptr;
+		}
+		statenodesamount[i] = 0;
+	}
+	statenum = 0;
+	// λ״̬ģʽ½ڵ㲻ڹϣУչĽڵ㣨һ״̬ͷ
+	if (bitstate.size() > 0) {
+		for (std::list<StateNode*>::iterator it = unexploidlist.begin(); it != unexploidlist.end(); it++) {
+			delete (*it)->currentstate;
+			delete *it;
 		}
 	}
-	delete statenodes;
-	delete statenodesamount;
+	unexploidlist.clear();
+	steplist.clear();
+	nodeorder.clear();
 }
 
 StateNode * Solver::addState(State * state) {
-	int code = 0;
-	// Ϊ1Ϊ0
-	for (int i = 0; i < height; i++) {
-		for (int j = 0; j < width; j++) {
-			if (state->tiles[i * width + j] == Box || state->tiles[i * width + j] == BoxinAid) {
-				code += i * width + j;
+	TRACE_COUNT("Solver::addState");
+	if (bitstate.size() > 0) {
+		long long positions[MAX_BIT_HASHES];
+		bitPositions(state, positions);
+		// ǰиʣ״̬λǡöѱ״̬λ
+		omissionExpected += pow((double)bitsetnum / bitnum, bithashnum);
+		for (int k = 0; k < bithashnum; k++) {
+			unsigned long long mask = 1ull << (positions[k] & 63);
+			if (!(bitstate[positions[k] >> 6] & mask)) {
+				bitstate[positions[k] >> 6] |= mask;
+				bitsetnum++;
 			}
 		}
+		statenum++;
+		StateNode * sn = new StateNode();
+		sn->currentstate = state;
+		return sn;
 	}
-	code = code % (height * width);
-	statenodesamount[code]++;
-	// std::wcout << code << "\n";
-	return statenodes[code]->addState(state);
+	if (statenum >= bucketnum * 2) {
+		rehash();
+	}
+	StateNode * sn = new StateNode();
+	sn->currentstate = state;
+	sn->code = state->ops->boxCode(state->tiles, width, height);
+	int bucket = sn->code & (bucketnum - 1);
+	sn->nextstate = statenodes[bucket];
+	statenodes[bucket] = sn;
+	statenodesamount[bucket]++;
+	statenum++;
+	if (checkpoint != nullptr) {
+		sn->id = (int)nodeorder.size();
+		nodeorder.push_back(sn);
+	}
+	return sn;
 }
 bool Solver::ifContain(State * state) {
-	int code = 0;
-	// Ϊ1Ϊ0
-	for (int i = 0; i < height; i++) {
-		for (int j = 0; j < width; j++) {
-			if (state->tiles[i * width + j] == Box || state->tiles[i * width + j] == BoxinAid) {
-				code += i * width + j;
+	TRACE_COUNT("Solver::ifContain");
+	if (bitstate.size() > 0) {
+		long long positions[MAX_BIT_HASHES];
+		bitPositions(state, positions);
+		for (int k = 0; k < bithashnum; k++) {
+			if (!(bitstate[positions[k] >> 6] & (1ull << (positions[k] & 63)))) {
+				return false;
 			}
 		}
+		return true;
 	}
-	code = code % (height * width);
-	// std::wcout << code << "\n";
-	if (statenodes[code]->ifContain(state)) {
+	unsigned int code = state->ops->boxCode(state->tiles, width, height);
+	StateNode * head = statenodes[code & (bucketnum - 1)];
+	if (head != nullptr && head->ifContain(state, code)) {
 		return true;
 	}
 
 	return false;
 }
 
+void Solver::bitPositions(State * state, long long * positions) {
+	// ˫عϣkλΪh1 + k * h2
+	unsigned long long h1 = state->ops->stateHash(state->tiles, width, height);
+	unsigned long long h2 = h1 * 0x9E3779B97F4A7C15ull;
+	h2 = (h2 ^ (h2 >> 29)) | 1;
+	for (int k = 0; k < bithashnum; k++) {
+		positions[k] = (long long)((h1 + k * h2) & (unsigned long long)(bitnum - 1));
+	}
+}
+
+bool Solver::setBitState(long long bytes, int hashnum) {
+	if (iterNum > 0 || checkpoint != nullptr || unexploidlist.size() != 1 || hashnum < 1 || hashnum > MAX_BIT_HASHES) {
+		return false;
+	}
+	// λȡbytes * 82ݣһ64λ
+	long long bits = 64;
+	while (bits * 2 <= bytes * 8) {
+		bits *= 2;
+	}
+	State * root = unexploidlist.front()->currentstate->clone();
+	clear();
+	// ϣֻСͰ
+	delete[] statenodes;
+	delete[] statenodesamount;
+	bucketnum = 1;
+	statenodes = new StateNode*[bucketnum];
+	statenodesamount = new int[bucketnum];
+	statenodes[0] = nullptr;
+	statenodesamount[0] = 0;
+	bitstate.assign((size_t)(bits / 64), 0);
+	bitnum = bits;
+	bithashnum = hashnum;
+	bitsetnum = 0;
+	omissionExpected = 0;
+	unexploidlist.push_back(addState(root));
+	return true;
+}
+
+double Solver::omissionProbability() {
+	// β໥ʱ©һ״̬ĸ
+	return 1 - exp(-omissionExpected);
+}
+
+void Solver::rehash() {
+	TRACE_SCOPE("Solver::rehash");
+	int newbucketnum = bucketnum * 2;
+	StateNode ** newstatenodes = new StateNode*[newbucketnum];
+	int * newstatenodesamount = new int[newbucketnum];
+	for (int i = 0; i < newbucketnum; i++) {
+		newstatenodes[i] = nullptr;
+		newstatenodesamount[i] = 0;
+	}
+	for (int i = 0; i < bucketnum; i++) {
+		StateNode * sn = statenodes[i];
+		while (sn != nullptr) {
+			StateNode * next = sn->nextstate;
+			int bucket = sn->code & (newbucketnum - 1);
+			sn->nextstate = newstatenodes[bucket];
+			newstatenodes[bucket] = sn;
+			newstatenodesamount[bucket]++;
+			sn = next;
+		}
+	}
+	delete[] statenodes;
+	delete[] statenodesamount;
+	statenodes = newstatenodes;
+	statenodesamount = newstatenodesamount;
+	bucketnum = newbucketnum;
+}
+
 // Զ
 int Solver::run() {
-	iterNum = 0;
+	SolveLimits limits;
+	return run(limits);
+}
+
+long long Solver::memoryUsage() {
+	long long perstate = sizeof(State) + sizeof(StateNode) + (long long)width * height * sizeof(TileType);
+	// нڵԼΪָ
+	long long perlist = 3 * sizeof(void *);
+	if (bitstate.size() > 0) {
+		return bitnum / 8 + (long long)unexploidlist.size() * (perstate + perlist);
+	}
+	return statenum * perstate + (long long)unexploidlist.size() * perlist
+		+ (long long)bucketnum * (sizeof(StateNode *) + sizeof(int)) + (long long)nodeorder.size() * sizeof(StateNode *);
+}
+
+int Solver::run(const SolveLimits & limits) {
+	TRACE_SCOPE("Solver::run");
+	int res = search(limits);
+	TRACE_COUNTERS("Solver::counts");
+	return res;
+}
+
+int Solver::search(const SolveLimits & limits) {
+	std::chrono::steady_clock::time_point starttime = std::chrono::steady_clock::now();
+	double lastprogress = 0;
+	int startiter = iterNum;
+	bool ifcheck = limits.seconds > 0 || limits.maxNodes > 0 || limits.maxMemory > 0 || limits.cancel != nullptr || limits.handleCancel != nullptr || limits.onProgress;
 	while (true) {
 		iterNum++;
 		
 		if (unexploidlist.size() == 0) {
 			return -1;
 		}
+		// ÿ256εһԴƣƵȡʱ
+		if (ifcheck && (iterNum - startiter) % 256 == 1) {
+			double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - starttime).count();
+			long long memory = memoryUsage();
+			bool ifstop = false;
+			ifstop = ifstop || (limits.cancel != nullptr && limits.cancel->load());
+			ifstop = ifstop || (limits.handleCancel != nullptr && limits.handleCancel->load());
+			ifstop = ifstop || (limits.seconds > 0 && elapsed >= limits.seconds);
+			ifstop = ifstop || (limits.maxNodes > 0 && statenum >= limits.maxNodes);
+			ifstop = ifstop || (limits.maxMemory > 0 && memory >= limits.maxMemory);
+			if (ifstop) {
+				// εûչڵ㣬ֹٴεrun()
+				iterNum--;
+				// дһȼ¼Ӽָʱʧϴμ¼֮
+				if (checkpoint != nullptr) {
+					checkpoint->append(nodeorder, expandedNum, iterNum);
+				}
+				return 0;
+			}
+			if (limits.onProgress && elapsed - lastprogress >= limits.progressInterval) {
+				lastprogress = elapsed;
+				SolveProgress progress;
+				progress.depth = unexploidlist.front()->depth;
+				progress.frontier = (int)unexploidlist.size();
+				progress.iterNum = iterNum;
+				progress.statenum = statenum;
+				progress.elapsed = elapsed;
+				progress.nodesPerSecond = elapsed > 0 ? (iterNum - startiter) / elapsed : 0;
+				progress.memory = memory;
+				progress.omission = omissionProbability();
+				limits.onProgress(progress);
+			}
+		}
+		// ʱչnodeorder[expandedNum]֮Ľڵ㣬д
+		if (checkpoint != nullptr && (iterNum - startiter) % 256 == 1) {
+			std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+			if (std::chrono::duration<double>(now - lastcheckpoint).count() >= checkpointinterval) {
+				checkpoint->append(nodeorder, expandedNum, iterNum - 1);
+				lastcheckpoint = now;
+			}
+			else {
+				// ĽڵʱддʱֻʣһεĽڵ
+				checkpoint->appendNodes(nodeorder);
+			}
+		}
+		// ʱÿչ65536ڵһμʱϿԿȵƵ
+		TRACE_COUNT("Solver::expand");
+		if (iterNum % 65536 == 0) {
+			TRACE_COUNTERS("Solver::counts");
+		}
 		StateNode * orisn = unexploidlist.front();
 		int depth = orisn->depth;
 
 		unexploidlist.pop_front();
+		expandedNum++;
 		State * oristate = orisn->currentstate;
 		
 		// map.drawMap(oristate);
@@ -101,7 +309,7 @@ int Solver::run() {
 								/*
 								if (unexploidlist.size() % 10000 == 0) {
 									std::wcout << unexploidlist.size() << "  " << depth << "\n";
-									for (int am = 0; am < height * width; am++) {
+									for (int am = 0; am < bucketnum; am++) {
 										std::wcout << statenodesamount[am] << "  ";
 									}
 									std::wcout << "\n";
@@ -110,7 +318,8 @@ int Solver::run() {
 
 								StateNode * sn = addState(newstate);
 								sn->depth = depth + 1;
-								sn->parentstate = orisn;
+								// λ״̬ģʽչĽڵᱻͷţ¼ڵ
+								sn->parentstate = bitstate.size() > 0 ? nullptr : orisn;
 								unexploidlist.push_back(sn);
 
 								if (newstate->ifWin()) {
@@ -119,6 +328,12 @@ int Solver::run() {
 										steplist.push_front(tempsn);
 										tempsn = tempsn->parentstate;
 									}
+									solutionDepth = sn->depth;
+									delete tempstate;
+									if (bitstate.size() > 0) {
+										delete oristate;
+										delete orisn;
+									}
 									return 1;
 								}
 							}
@@ -128,6 +343,11 @@ int Solver::run() {
 			}
 		}
 		delete tempstate;
+		// λ״̬ģʽֻдչб״̬
+		if (bitstate.size() > 0) {
+			delete oristate;
+			delete orisn;
+		}
 	}
 }
 
@@ -137,4 +357,67 @@ void Solver::drawStep() {
 		steplist.pop_front();
 		std::wcout << "\n";
 	}
+}
+
+bool Solver::resume(const char * path) {
+	TRACE_SCOPE("Solver::resume");
+	if (unexploidlist.size() == 0 || bitstate.size() > 0) {
+		return false;
+	}
+	Checkpoint reader(unexploidlist.front()->currentstate);
+	std::vector<CheckpointNode> records;
+	int expanded = 0;
+	int iter = 0;
+	if (!reader.read(path, records, expanded, iter)) {
+		return false;
+	}
+	// ǽںĿͬӳʼλòͬļ㲻ʹ
+	State * root = reader.buildState(records[0]);
+	bool same = root->isEqual(unexploidlist.front()->currentstate);
+	delete root;
+	if (!same) {
+		return false;
+	}
+	clear();
+	std::vector<StateNode*> nodes;
+	for (int n = 0; n < (int)records.size(); n++) {
+		StateNode * sn = addState(reader.buildState(records[n]));
+		sn->id = n;
+		sn->depth = records[n].depth;
+		if (records[n].parent >= 0 && records[n].parent < n) {
+			sn->parentstate = nodes[records[n].parent];
+		}
+		nodes.push_back(sn);
+	}
+	for (int n = expanded; n < (int)nodes.size(); n++) {
+		unexploidlist.push_back(nodes[n]);
+	}
+	nodeorder.swap(nodes);
+	expandedNum = expanded;
+	iterNum = iter;
+	return true;
+}
+
+bool Solver::setCheckpoint(const char * path, double seconds) {
+	if (checkpoint != nullptr) {
+		delete checkpoint;
+		checkpoint = nullptr;
+	}
+	if (seconds <= 0 || bitstate.size() > 0 || (unexploidlist.size() == 0 && nodeorder.size() == 0)) {
+		return false;
+	}
+	// ѾйʱչĽڵûм¼дļ޷ָ
+	if (iterNum > 0 && nodeorder.size() == 0) {
+		return false;
+	}
+	// δָֻгʼ״̬һڵ
+	if (nodeorder.size() == 0) {
+		StateNode * root = unexploidlist.front();
+		root->id = 0;
+		nodeorder.push_back(root);
+	}
+	checkpoint = new Checkpoint(nodeorder.front()->currentstate);
+	checkpointinterval = seconds;
+	lastcheckpoint = std::chrono::steady_clock::now();
+	return checkpoint->create(path, nodeorder, expandedNum, iterNum);
 }
\ No newline at end of file
@@ -2,23 +2,108 @@
 #include "State.h"
 #include "StateNode.h"
 #include "Map.h"
+#include "Checkpoint.h"
 #include <list>
+#include <vector>
+#include <atomic>
+#include <functional>
+#include <chrono>
+// ȣrun()Եػص
+struct SolveProgress {
+	// ǰչڵ
+	int depth;
+	// չг
+	int frontier;
+	int iterNum;
+	int statenum;
+	// ʱ䣨룩ƽÿչĽڵ
+	double elapsed;
+	double nodesPerSecond;
+	// ڴռãֽڣ
+	long long memory;
+	// λ״̬ģʽ¹©һ״̬ĸʣȷģʽΪ0
+	double omission;
+};
+// Դƣֵ0ʾ
+struct SolveLimits {
+	// ʱޣ룩
+	double seconds = 0;
+	// ϣе״̬
+	int maxNodes = 0;
+	// ڴޣֽڣ
+	long long maxMemory = 0;
+	// Ȼصļ룩صصִ߳е
+	double progressInterval = 1.0;
+	std::function<void(const SolveProgress &)> onProgress;
+	// ЭʽȡΪtruerun()һμʱ0
+	// cancelɵṩԱ⹲handleCancelAsyncSolverȾֻȡһ
+	std::atomic<bool> * cancel = nullptr;
+	std::atomic<bool> * handleCancel = nullptr;
+};
 class Solver {
 public:
 	Solver(State* state);
 	~Solver();
+	// 1ʾн⣬-1ʾ޽⣬0ʾԴƻȡֹ
 	int run();
+	int run(const SolveLimits & limits);
+	// 㵱ǰռõڴ棨ֽڣ
+	long long memoryUsage();
 	bool ifContain(State * state);
 	StateNode * addState(State * state);
 	void drawStep();
+	// Ӽļָѷʵ״̬ʹչУļڻؿʱfalse
+	bool resume(const char * path);
+	// ״̬ÿ256ε׷дļÿsecondsдһȼ¼ˢļ
+	// ÿдֻͣ256ε״̬йأģ
+	// run()֮ǰresume()֮
+	bool setCheckpoint(const char * path, double seconds);
+	// λ״̬ģʽѷʵ״̬棬ֻbytesֽڵλhashnumϣλ
+	// ֻдչб״̬ڴ̶ǹϣͻ״̬Ϊѷʶ©
+	// ˷-1֤޽⣬ҵʱsteplistֻһ״̬
+	// run()֮ǰãͬʱʹ
+	bool setBitState(long long bytes, int hashnum);
+	// ©һ״̬ĸʣȷģʽΪ0
+	double omissionProbability();
 	int width;
 	int height;
+	// ϣÿͰһStateNodeͰΪ2ݣ״̬ʱ
 	StateNode ** statenodes;
 	int * statenodesamount;
+	int bucketnum;
+	// ϣе״̬
+	int statenum;
 	std::list <StateNode*> unexploidlist;
 	std::list <StateNode*> steplist;
 	Map map;
 	// ܵĵ
 	int iterNum;
+	// չĽڵдչǡǰ˳еĺһνڵ
+	int expandedNum;
+	// ̽ӴɹЧ
+	int solutionDepth;
+	// λ״̬ģʽ©״̬
+	double omissionExpected;
 	
+private:
+	// run()
+	int search(const SolveLimits & limits);
+	// Ͱ·нڵ
+	void rehash();
+	// ͷŹϣе״̬ն
+	void clear();
+	Checkpoint * checkpoint;
+	// дȼ¼ļ룩ϴдʱ
+	double checkpointinterval;
+	std::chrono::steady_clock::time_point lastcheckpoint;
+	// ˳еȫڵ㣬ֻдʱ¼
+	std::vector<StateNode*> nodeorder;
+	// λ״̬ģʽλ飬ΪʱʹþȷĹϣ
+	std::vector<unsigned long long> bitstate;
+	// λλ2ݣÿ״̬Ĺϣλλλ
+	long long bitnum;
+	int bithashnum;
+	long long bitsetnum;
+	// ״̬λеĸλ
+	void bitPositions(State * state, long long * positions);
 };
\ No newline at end of file
@@ -1,11 +1,13 @@
 #include "pch.h"
 #include "State.h"
+#include "Trace.h"
 #include <iostream>
 
 State::State(int w, int h)
 {
 	this->width = w;
 	this->height = h;
+	this->ops = selectBoardOps(w, h);
 }
 
 State::~State() {
@@ -108,6 +110,7 @@ void State::changLoc(int newcx, int newcy, int newcx2, int newcy2) {
 }
 
 State* State::clone() {
+	TRACE_COUNT("State::clone");
 	State * newstate = new State(width, height);
 	newstate->tiles = new TileType[height * width];
 	for (int i = 0; i < this->height; i++) {
@@ -121,15 +124,7 @@ State* State::clone() {
 }
 
 bool State::isEqual(State * tempst) {
-	for (int i = 0; i < this->height; i++) {
-		for (int j = 0; j < this->width; j++) {
-			if (tempst->tiles[i * this->width + j] != tiles[i * this->width + j]) {
-				return false;
-			}
-		}
-	}
-	// std::wcout << "true\n";
-	return true;
+	return ops->isEqual(tempst->tiles, tiles, width, height);
 }
 // жһǷͨ
 bool State::stepOn(TileType* tt, int i, int  j) {
@@ -145,25 +140,12 @@ bool State::stepOn(TileType* tt, int i, int  j) {
 }
 // ÷㷨нɫܹﵽĵص㡣
 void State::charFloodFill() {
-	while (true) {
-		bool ifChange = false;
-		for (int i = 1; i < this->height - 1; i++) {
-			for (int j = 1; j < this->width - 1; j++) {
-				if (tiles[i * this->width + j] == Character || tiles[i*this->width + j] == CharacterinAid) {
-					ifChange = ifChange || stepOn(tiles, i - 1, j);
-					ifChange = ifChange || stepOn(tiles, i + 1, j);
-					ifChange = ifChange || stepOn(tiles, i, j - 1);
-					ifChange = ifChange || stepOn(tiles, i, j + 1);
-				}
-			}
-		}
-		if (!ifChange) {
-			break;
-		}
-	}
+	TRACE_COUNT("State::charFloodFill");
+	ops->floodFill(tiles, width, height);
 }
 // жһܷضƶܣ򷵻ƶ״̬
 State* State::boxPushed(int i, int j, Direction d) {
+	TRACE_COUNT("State::boxPushed");
 	int newi, newj, ci, cj;
 	if (d == D_UP) {
 		newi = i - 1;
@@ -200,16 +182,7 @@ State* State::boxPushed(int i, int j, Direction d) {
 	}
 	State * res = clone();
 	// еCharacterΪFloorеCharacterInAidΪAid
-	for (int i = 0; i < this->height; i++) {
-		for (int j = 0; j < this->width; j++) {
-			if (res->tiles[i * this->width + j] == Character) {
-				res->tiles[i * this->width + j] = Floor;
-			}
-			if (res->tiles[i * this->width + j] == CharacterinAid) {
-				res->tiles[i * this->width + j] = Aid;
-			}
-		}
-	}
+	ops->clearCharacter(res->tiles, width, height);
 	if (res->tiles[newi*width + newj] == Floor) {
 		res->tiles[newi*width + newj] = Box;
 	}else if (res->tiles[newi*width + newj] == Aid) {
@@ -234,6 +207,7 @@ State* State::boxPushed(int i, int j, Direction d) {
 
 // ֦жǷ
 bool State::ifDead() {
+	TRACE_COUNT("State::ifDead");
 	bool res = false;
 	res = res || ifWallCorner();
 	res = res || ifTwoxTwo();
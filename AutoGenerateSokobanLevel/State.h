@@ -1,5 +1,6 @@
 #pragma once
 #include "TileType.h"
+#include "BoardKernel.h"
 class State {
 public:
 	State(int w, int h);
@@ -10,6 +11,8 @@ public:
 	int height;
 	int cx;
 	int cy;
+	// ̳ߴѡڲѭʵ
+	const BoardOps * ops;
 	// жǷǻʤ״̬
 	bool ifWin();
 	// ƶɫ
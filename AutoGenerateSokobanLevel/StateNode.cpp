@@ -1,35 +1,27 @@
 #include "pch.h"
 #include "StateNode.h"
+// ͷϵ״̬Լڵ㣬ܺܳ˲ʹõݹ
 void StateNode::deleteNode() {
-	if (nextstate != nullptr) {
-		nextstate->deleteNode();
+	StateNode * sn = nextstate;
+	while (sn != nullptr) {
+		StateNode * next = sn->nextstate;
+		if (sn->currentstate != nullptr) {
+			delete sn->currentstate;
+		}
+		delete sn;
+		sn = next;
 	}
+	nextstate = nullptr;
 	if (currentstate != nullptr) {
 		delete currentstate;
+		currentstate = nullptr;
 	}
 }
-bool StateNode::ifContain(State * state) {
-	if (this->currentstate != nullptr && this->currentstate->isEqual(state)) {
-		return true;
-	}
-	if (this->nextstate != nullptr) {
-		return this->nextstate->ifContain(state);
+bool StateNode::ifContain(State * state, unsigned int code) {
+	for (StateNode * sn = this; sn != nullptr; sn = sn->nextstate) {
+		if (sn->currentstate != nullptr && sn->code == code && sn->currentstate->isEqual(state)) {
+			return true;
+		}
 	}
 	return false;
-}
-
-StateNode * StateNode::addState(State * state) {
-	if (currentstate == nullptr) {
-		this->currentstate = state;
-		return this;
-	}
-	else if (nextstate != nullptr) {
-		return nextstate->addState(state);
-	}
-	else {
-		StateNode * sn = new StateNode();
-		sn->currentstate = state;
-		nextstate = sn;
-		return sn;
-	}
 }
\ No newline at end of file
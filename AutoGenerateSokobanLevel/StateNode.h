@@ -6,7 +6,10 @@ public:
 	StateNode * nextstate = nullptr;
 	StateNode * parentstate = nullptr;
 	void deleteNode();
-	bool ifContain(State * state);
-	StateNode * addState(State * state);
-	int depth;
+	bool ifContain(State * state, unsigned int code);
+	int depth = 0;
+	// currentstateӹϣֵȽ֮ǰȱȽ
+	unsigned int code = 0;
+	// ˳ıţֻдʱʹ
+	int id = -1;
 };
\ No newline at end of file
@@ -0,0 +1,148 @@
+#include "pch.h"
+#include "Trace.h"
+#ifdef SOKOBAN_TRACE
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+struct TraceCounter {
+	const char * name;
+	long long value;
+};
+struct TraceEvent {
+	const char * name;
+	long long begin;
+	long long duration;
+	// ¼ȡֵcountersе±귶Χ¼߶Ϊ0
+	int counterbegin;
+	int counterend;
+};
+// ÿ߳һ߳̽ȫбУֱ˳
+struct TraceBuffer {
+	int tid;
+	std::string threadname;
+	std::vector<TraceEvent> events;
+	// δļֺ٣ָ˳Ҽ
+	std::vector<TraceCounter> pending;
+	// ļ¼ȡֵ
+	std::vector<TraceCounter> counters;
+	long long droppedNum;
+};
+
+static std::mutex bufferlock;
+static std::vector<TraceBuffer *> buffers;
+static thread_local TraceBuffer * localbuffer = nullptr;
+
+static TraceBuffer * threadBuffer() {
+	if (localbuffer == nullptr) {
+		std::lock_guard<std::mutex> guard(bufferlock);
+		localbuffer = new TraceBuffer();
+		localbuffer->tid = (int)buffers.size() + 1;
+		localbuffer->droppedNum = 0;
+		localbuffer->events.reserve(4096);
+		buffers.push_back(localbuffer);
+	}
+	return localbuffer;
+}
+
+long long Trace::now() {
+	static const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+void Trace::record(const char * name, long long begin, long long end) {
+	TraceBuffer * buffer = threadBuffer();
+	if ((int)buffer->events.size() >= MAX_EVENTS) {
+		buffer->droppedNum++;
+		return;
+	}
+	TraceEvent event;
+	event.name = name;
+	event.begin = begin;
+	event.duration = end - begin;
+	event.counterbegin = 0;
+	event.counterend = 0;
+	buffer->events.push_back(event);
+}
+
+void Trace::count(const char * name) {
+	TraceBuffer * buffer = threadBuffer();
+	for (int i = 0; i < (int)buffer->pending.size(); i++) {
+		if (buffer->pending[i].name == name) {
+			buffer->pending[i].value++;
+			return;
+		}
+	}
+	TraceCounter counter;
+	counter.name = name;
+	counter.value = 1;
+	buffer->pending.push_back(counter);
+}
+
+void Trace::flushCounters(const char * name) {
+	TraceBuffer * buffer = threadBuffer();
+	if (buffer->pending.size() == 0) {
+		return;
+	}
+	if ((int)buffer->events.size() >= MAX_EVENTS) {
+		buffer->droppedNum++;
+	}
+	else {
+		TraceEvent event;
+		event.name = name;
+		event.begin = now();
+		event.duration = 0;
+		event.counterbegin = (int)buffer->counters.size();
+		for (int i = 0; i < (int)buffer->pending.size(); i++) {
+			buffer->counters.push_back(buffer->pending[i]);
+		}
+		event.counterend = (int)buffer->counters.size();
+		buffer->events.push_back(event);
+	}
+	for (int i = 0; i < (int)buffer->pending.size(); i++) {
+		buffer->pending[i].value = 0;
+	}
+}
+
+void Trace::setThreadName(const char * name) {
+	threadBuffer()->threadname = name;
+}
+
+bool Trace::save(const char * path) {
+	std::ofstream out(path, std::ios::trunc);
+	if (!out) {
+		return false;
+	}
+	std::lock_guard<std::mutex> guard(bufferlock);
+	out << "{\"traceEvents\":[\n";
+	bool first = true;
+	for (int b = 0; b < (int)buffers.size(); b++) {
+		TraceBuffer * buffer = buffers[b];
+		std::string threadname = buffer->threadname.size() > 0 ? buffer->threadname : "thread " + std::to_string(buffer->tid);
+		out << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->tid
+			<< ",\"args\":{\"name\":\"" << threadname << "\"}}";
+		first = false;
+		for (int e = 0; e < (int)buffer->events.size(); e++) {
+			TraceEvent & event = buffer->events[e];
+			if (event.counterend > event.counterbegin) {
+				out << ",\n{\"name\":\"" << event.name << "\",\"ph\":\"C\",\"pid\":1,\"tid\":" << buffer->tid
+					<< ",\"ts\":" << event.begin << ",\"args\":{";
+				for (int c = event.counterbegin; c < event.counterend; c++) {
+					out << (c == event.counterbegin ? "" : ",") << "\"" << buffer->counters[c].name << "\":" << buffer->counters[c].value;
+				}
+				out << "}}";
+				continue;
+			}
+			out << ",\n{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->tid
+				<< ",\"ts\":" << event.begin << ",\"dur\":" << event.duration << "}";
+		}
+		if (buffer->droppedNum > 0) {
+			out << ",\n{\"name\":\"dropped events\",\"ph\":\"C\",\"pid\":1,\"tid\":" << buffer->tid
+				<< ",\"ts\":" << now() << ",\"args\":{\"dropped\":" << buffer->droppedNum << "}}";
+		}
+	}
+	out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+	return (bool)out;
+}
+#endif
\ No newline at end of file
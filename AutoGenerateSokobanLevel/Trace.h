@@ -0,0 +1,54 @@
+#pragma once
+// ȵ·ļʱ٣Chrome/PerfettoԴ򿪵trace-event JSONļ
+// ֻĿԤмSOKOBAN_TRACEʱŻȥк궼ǿյġ
+//   TRACE_SCOPE("")       ¼ǰĿʼʱͳʱ䣬ֻںѡؿĴȲ
+//   TRACE_COUNT("")       ǰ̵߳ļһÿ״ִ̬еȵ
+//   TRACE_COUNTERS("")    ѵǰ߳ϴļдһ¼
+//   TRACE_THREAD_NAME("") õǰ߳ʱʾ
+//   TRACE_SAVE("trace.json")  д̵߳ļ¼Ӧڹ̶߳
+#ifdef SOKOBAN_TRACE
+#include <chrono>
+
+class Trace {
+public:
+	// ǰʱ䣬λΪ΢룬ӽڵһεÿʼ
+	static long long now();
+	// ¼һ¼nameַ
+	static void record(const char * name, long long begin, long long end);
+	// ֻڴۼӣ¼ԶСTraceScope
+	static void count(const char * name);
+	static void flushCounters(const char * name);
+	static void setThreadName(const char * name);
+	static bool save(const char * path);
+	// ÿ߳ౣ¼¼ֻ
+	static const int MAX_EVENTS = 4000000;
+};
+
+class TraceScope {
+public:
+	TraceScope(const char * name) {
+		this->name = name;
+		begin = Trace::now();
+	}
+	~TraceScope() {
+		Trace::record(name, begin, Trace::now());
+	}
+private:
+	const char * name;
+	long long begin;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(tracescope, __LINE__)(name)
+#define TRACE_COUNT(name) Trace::count(name)
+#define TRACE_COUNTERS(name) Trace::flushCounters(name)
+#define TRACE_THREAD_NAME(name) Trace::setThreadName(name)
+#define TRACE_SAVE(path) Trace::save(path)
+#else
+#define TRACE_SCOPE(name)
+#define TRACE_COUNT(name)
+#define TRACE_COUNTERS(name)
+#define TRACE_THREAD_NAME(name)
+#define TRACE_SAVE(path)
+#endif
\ No newline at end of file
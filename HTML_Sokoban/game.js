@@ -648,7 +648,9 @@ const config = {
     canvasHeight: 0,  // 将在初始化时设置
     useAIGeneration: true, // 是否使用AI生成关卡
     aiGenerationMaxTries: 100, // 适当减少AI生成关卡最大尝试次数，原来是100
-    aiTimeout: 8000 // AI生成超时时间（毫秒）
+    aiTimeout: 8000, // AI生成超时时间（毫秒）
+    levelServerUrl: 'http://127.0.0.1:8927', // 本机关卡服务地址（C++程序的 --daemon 模式），为空时不使用
+    levelServerTimeout: 300 // 关卡服务请求超时时间（毫秒），超时后改用浏览器内AI生成
 };
 
 // 默认设置，用于重置 - 将从配置文件加载
@@ -845,6 +847,41 @@ function updateAILevelInfo(minSteps, iterations, wallCount) {
     hideGenerationProgress();
 }
 
+// 从本机关卡服务获取一个预先生成好的关卡，服务未启动或对应尺寸的关卡池为空时返回null
+async function fetchServerLevel() {
+    if (!config.levelServerUrl) {
+        return null;
+    }
+    const controller = new AbortController();
+    const timer = setTimeout(() => controller.abort(), config.levelServerTimeout);
+    try {
+        const url = `${config.levelServerUrl}/level?w=${config.boardSize.width}&h=${config.boardSize.height}`;
+        const response = await fetch(url, { signal: controller.signal });
+        if (!response.ok) {
+            return null;
+        }
+        const data = await response.json();
+        // 服务返回XSB格式的行，转换为游戏格式
+        const level = { board: [], playerPos: { x: 0, y: 0 }, boxes: [], targets: [], minSteps: data.steps, wallCount: 0 };
+        data.rows.forEach((row, y) => {
+            level.board.push([]);
+            for (let x = 0; x < row.length; x++) {
+                const c = row[x];
+                level.board[y].push(c === '#' ? 'wall' : 'floor');
+                if (c === '#') level.wallCount++;
+                if (c === '$' || c === '*') level.boxes.push({ x, y });
+                if (c === '.' || c === '*' || c === '+') level.targets.push({ x, y });
+                if (c === '@' || c === '+') level.playerPos = { x, y };
+            }
+        });
+        return level;
+    } catch (error) {
+        return null;
+    } finally {
+        clearTimeout(timer);
+    }
+}
+
 // 生成新关卡
 async function generateNewLevel() {
     // 如果AI演示正在进行，先结束演示
@@ -886,8 +923,19 @@ async function generateNewLevel() {
 
     initializeBoard();
 
-    // 使用AI生成关卡
-    if (config.useAIGeneration && AILevelGenerator) {
+    // 优先使用关卡服务中预先生成的关卡，服务不可用时才在浏览器内生成
+    const serverLevel = config.useAIGeneration ? await fetchServerLevel() : null;
+
+    if (serverLevel) {
+        clearTimeout(generationTimeout);
+        gameState.board = serverLevel.board;
+        gameState.playerPos = serverLevel.playerPos;
+        gameState.boxes = serverLevel.boxes;
+        gameState.targets = serverLevel.targets;
+        gameState.minSolutionSteps = serverLevel.minSteps;
+        console.log(`关卡服务提供的关卡最少推箱子次数: ${serverLevel.minSteps}, 墙壁数量: ${serverLevel.wallCount}`);
+        updateAILevelInfo(serverLevel.minSteps, 0, serverLevel.wallCount);
+    } else if (config.useAIGeneration && AILevelGenerator) {
         try {
             // 获取配置参数：优先使用用户保存的设置，否则使用配置文件默认值（fileSettings已在上面获取）
             const currentSettings = {